@@ -0,0 +1,82 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <CanvasTriangle.h>
+#include <Rasteriser.h>
+#include <VertexProjection.h>
+
+#define WIDTH 320
+#define HEIGHT 240
+
+// Fills the same triangle over and over, nudging it closer each time so every covered pixel
+// passes the depth test and gets written, and reports how many pixels per second that is
+void benchmarkTriangle(const std::string &name, CanvasTriangle triangle, int iterations) {
+	std::vector<uint32_t> colours(WIDTH * HEIGHT, 0);
+	std::vector<float> depths(WIDTH * HEIGHT, 0.0f);
+	RasterBuffer target(colours.data(), depths.data(), WIDTH);
+	PixelRect screen(0, 0, WIDTH - 1, HEIGHT - 1);
+
+	// One untimed pass to count coverage and warm the caches
+	for (CanvasPoint &vertex : triangle.vertices) vertex.depth = 1.0f;
+	fillTriangle(triangle, screen, 0xFFFFFFFF, target);
+	size_t coveredPixels = 0;
+	for (uint32_t colour : colours) if (colour != 0) coveredPixels++;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		for (CanvasPoint &vertex : triangle.vertices) vertex.depth = 2.0f + i;
+		fillTriangle(triangle, screen, 0xFF000000 + i, target);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	double pixelsPerSecond = coveredPixels * double(iterations) / elapsed.count();
+	double nanosecondsPerTriangle = elapsed.count() * 1e9 / iterations;
+	std::cout << std::left << std::setw(14) << name
+	          << std::right << std::setw(8) << coveredPixels << " px"
+	          << std::setw(12) << std::fixed << std::setprecision(1) << nanosecondsPerTriangle << " ns/tri"
+	          << std::setw(12) << std::setprecision(1) << pixelsPerSecond / 1e6 << " Mpx/s" << std::endl;
+}
+
+// Projects a cloud of vertices in front of the camera one at a time with projectVertex and then in batches
+// with projectVertices, and reports how many vertices per second each manages
+void benchmarkProjection(size_t vertexCount, int iterations) {
+	VertexBuffer vertices;
+	vertices.reserve(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++) {
+		vertices.push_back(glm::vec3(float(i % 101) / 50.0f - 1.0f, float(i % 97) / 48.0f - 1.0f, -1.0f - float(i % 89) / 44.0f));
+	}
+	glm::mat4 viewProjection = viewProjectionMatrix(glm::vec3(0.0f, 0.0f, 4.0f), glm::mat3(1.0f), 2.0f, 160.0f, WIDTH, HEIGHT);
+	ProjectedVertices projected;
+	projected.resize(vertexCount);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		for (size_t v = 0; v < vertexCount; v++) {
+			CanvasPoint point = projectVertex(viewProjection, vertices[v]);
+			projected.x[v] = point.x;
+			projected.y[v] = point.y;
+			projected.depth[v] = point.depth;
+		}
+	}
+	std::chrono::duration<double> reference = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) projectVertices(viewProjection, vertices, projected);
+	std::chrono::duration<double> batched = std::chrono::steady_clock::now() - start;
+
+	double totalVertices = double(vertexCount) * iterations;
+	std::cout << std::left << std::setw(14) << "projection" << std::right << std::setw(8) << vertexCount << " vertices"
+	          << std::setw(10) << std::fixed << std::setprecision(1) << totalVertices / reference.count() / 1e6 << " Mvert/s one at a time"
+	          << std::setw(10) << totalVertices / batched.count() / 1e6 << " Mvert/s batched" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+	std::cout << "fillTriangle kernel: " << rasterKernelName() << " (" << rasterKernelWidth() << " pixels wide)" << std::endl;
+	benchmarkTriangle("small", CanvasTriangle(CanvasPoint(100, 100), CanvasPoint(108, 103), CanvasPoint(102, 109)), 2000000);
+	benchmarkTriangle("medium", CanvasTriangle(CanvasPoint(100, 60), CanvasPoint(180, 90), CanvasPoint(120, 150)), 100000);
+	benchmarkTriangle("screen-filling", CanvasTriangle(CanvasPoint(0, 0), CanvasPoint(2 * WIDTH, 0), CanvasPoint(0, 2 * HEIGHT)), 5000);
+	benchmarkProjection(1000000, 20);
+	return 0;
+}
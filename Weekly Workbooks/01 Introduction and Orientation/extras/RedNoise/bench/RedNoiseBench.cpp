@@ -0,0 +1,341 @@
+// Times every stage of the two programs, from single barycentric conversions up to whole rasterised frames
+// of the Cornell boxes from workbooks 04 and 05, prints ns/op, triangles/s and pixels/s for each
+// and writes the same numbers as JSON so runs from different builds can be compared
+//
+//   RedNoiseBench [results.json]
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <CanvasPoint.h>
+#include <CanvasTriangle.h>
+#include <Colour.h>
+#include <DrawingWindow.h>
+#include <FrameProfiler.h>
+#include <IndexedMesh.h>
+#include <MappedFile.h>
+#include <MaterialTable.h>
+#include <ModelTriangle.h>
+#include <OBJParser.h>
+#include <Rasteriser.h>
+#include <RayTriangleIntersection.h>
+#include <RenderTarget.h>
+#include <SceneBundle.h>
+#include <TextureCache.h>
+#include <TextureMap.h>
+#include <Utils.h>
+// The drawing and rendering code the two programs are built from, so the benchmarks time their own functions
+#include "../src/ModellingPipeline.h"
+#include "../src/RedNoiseDrawing.h"
+
+#ifndef WORKBOOKS_DIR
+#define WORKBOOKS_DIR "../../.."
+#endif
+//where texture.ppm lives, the build points this at src
+#ifndef SCENE_DIR
+#define SCENE_DIR "src"
+#endif
+
+#define WIDTH 320
+#define HEIGHT 240
+
+struct BenchResult {
+	std::string name;
+	size_t iterations;
+	double nanosecondsPerOp;
+	double trianglesPerSecond;
+	double pixelsPerSecond;
+};
+
+std::vector<BenchResult> results;
+// Set by a self-check that found the code giving a wrong answer, so the bench exits with 1
+bool checksFailed = false;
+
+// Runs op once to warm up and then over and over for at least a quarter of a second
+// Each op is counted as drawing the given number of triangles and pixels (either can be 0)
+void measure(const std::string &name, double trianglesPerOp, double pixelsPerOp, const std::function<void(size_t)> &op) {
+	op(0);
+	size_t iterations = 0;
+	auto start = std::chrono::steady_clock::now();
+	std::chrono::duration<double> elapsed(0);
+	for (size_t batch = 1; elapsed.count() < 0.25; batch *= 2) {
+		for (size_t i = 0; i < batch; i++) op(iterations + i + 1);
+		iterations += batch;
+		elapsed = std::chrono::steady_clock::now() - start;
+	}
+	double seconds = elapsed.count();
+	BenchResult result{name, iterations, seconds * 1e9 / iterations,
+	                   trianglesPerOp * iterations / seconds, pixelsPerOp * iterations / seconds};
+	results.push_back(result);
+	std::cout << std::left << std::setw(46) << name << std::right << std::fixed << std::setprecision(1)
+	          << std::setw(14) << result.nanosecondsPerOp << " ns/op"
+	          << std::setw(10) << std::setprecision(3) << result.trianglesPerSecond / 1e6 << " Mtri/s" << std::setprecision(1)
+	          << std::setw(10) << result.pixelsPerSecond / 1e6 << " Mpx/s" << std::endl;
+}
+
+void writeJSON(const std::string &filename) {
+	std::ofstream output(filename);
+	output << "{\n  \"kernel\": \"" << rasterKernelName() << "\",\n  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult &result = results[i];
+		output << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+		       << ", \"ns_per_op\": " << result.nanosecondsPerOp
+		       << ", \"triangles_per_second\": " << result.trianglesPerSecond
+		       << ", \"pixels_per_second\": " << result.pixelsPerSecond << "}"
+		       << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	output << "  ]\n}\n";
+}
+
+size_t countNonZero(const uint32_t *pixels, size_t count) {
+	return std::count_if(pixels, pixels + count, [](uint32_t colour) { return colour != 0; });
+}
+
+// The 2D drawing functions of RedNoise, drawn into an offscreen window
+void benchmarkCanvas() {
+	DrawingWindow window = DrawingWindow::offscreen(WIDTH, HEIGHT);
+
+	glm::vec2 v0(0, HEIGHT - 1), v1((WIDTH - 1) / 2, 0), v2(WIDTH - 1, HEIGHT - 1);
+	float checksum = 0;
+	measure("convertToBarycentricCoordinates", 0, 1, [&](size_t i) {
+		checksum += convertToBarycentricCoordinates(v0, v1, v2, glm::vec2(i % WIDTH, (i / WIDTH) % HEIGHT)).x;
+	});
+	if (checksum == -1) std::cout << checksum << std::endl;
+
+	CanvasPoint from(10, 20), to(300, 200);
+	double linePixels = std::max(std::abs(to.x - from.x), std::abs(to.y - from.y)) + 1;
+	measure("RedNoise drawLine", 0, linePixels, [&](size_t i) {
+		rednoise::drawLine(window, from, to, Colour(i % 256, 0, 0));
+	});
+
+	CanvasTriangle triangle(CanvasPoint(160, 10), CanvasPoint(300, 230), CanvasPoint(10, 150));
+	window.clearPixels();
+	rednoise::drawFilledTriangle(window, triangle, Colour(255, 255, 255));
+	size_t trianglePixels = countNonZero(window.getPixelBuffer(), WIDTH * HEIGHT);
+	measure("RedNoise drawFilledTriangle", 1, trianglePixels, [&](size_t i) {
+		rednoise::drawFilledTriangle(window, triangle, Colour(i % 256, 255, 255));
+	});
+
+	// textureMapping takes its texture from the cache, only the first (untimed) call reads the file
+	CanvasPoint t0(160, 10), t1(300, 230), t2(10, 150);
+	t0.texturePoint = TexturePoint(195, 5);
+	t1.texturePoint = TexturePoint(395, 380);
+	t2.texturePoint = TexturePoint(65, 330);
+	CanvasTriangle textured(t0, t1, t2);
+	try {
+		window.clearPixels();
+		rednoise::textureMapping(window, textured);
+		size_t texturedPixels = countNonZero(window.getPixelBuffer(), WIDTH * HEIGHT);
+		measure("RedNoise textureMapping", 1, texturedPixels, [&](size_t) { rednoise::textureMapping(window, textured); });
+		// With the profiler recording, which times the texture stage
+		rednoise::profiler.setEnabled(true);
+		measure("RedNoise textureMapping profiled", 1, texturedPixels, [&](size_t) {
+			rednoise::profiler.beginFrame();
+			rednoise::textureMapping(window, textured);
+			rednoise::profiler.endFrame();
+		});
+		rednoise::profiler.setEnabled(false);
+		// The same triangle with its texture points spread over three turns of the texture
+		std::shared_ptr<const TextureMap> texture = textureCache().get(SCENE_DIR "/texture.ppm");
+		CanvasTriangle repeated = textured;
+		for (CanvasPoint &vertex : repeated.vertices) vertex.texturePoint = TexturePoint(vertex.texturePoint.x * 3, vertex.texturePoint.y * 3);
+		PixelRect screen(0, 0, WIDTH - 1, HEIGHT - 1);
+		measure("Rasteriser fillTriangleTextured wrap", 1, texturedPixels, [&](size_t) {
+			fillTriangleTextured(repeated, screen, *texture, TEXTURE_WRAP, window.getPixelBuffer(), WIDTH);
+		});
+	} catch (const std::exception &) {
+		std::cout << std::left << std::setw(46) << "RedNoise textureMapping" << "skipped, texture.ppm not found" << std::endl;
+	}
+}
+
+// Whether a point on the triangle's plane is inside it, on the inner side of all three edges (give or take slack)
+bool insideTriangle(const ModelTriangle &triangle, const glm::vec3 &point, float slack) {
+	const std::array<glm::vec3, 3> &v = triangle.vertices;
+	glm::vec3 normal = glm::cross(v[1] - v[0], v[2] - v[0]);
+	float tolerance = -slack * glm::dot(normal, normal);
+	for (int j = 0; j < 3; j++) {
+		if (glm::dot(glm::cross(v[(j + 1) % 3] - v[j], point - v[j]), normal) < tolerance) return false;
+	}
+	return true;
+}
+
+// The nearest hit along a ray found the slow way, with the plane of each triangle and which side of each edge the point is on
+// Goes through the mesh as ModelTriangles with a range for, so it doesn't share any code with findClosestIntersection
+bool bruteForceIntersection(const MeshView &mesh, const glm::vec3 &origin, const glm::vec3 &direction, float &nearest, size_t &hit) {
+	nearest = INFINITY;
+	size_t i = 0;
+	for (const ModelTriangle &triangle : mesh) {
+		const std::array<glm::vec3, 3> &v = triangle.vertices;
+		glm::vec3 normal = glm::cross(v[1] - v[0], v[2] - v[0]);
+		float along = glm::dot(direction, normal);
+		float t = along != 0.0f ? glm::dot(v[0] - origin, normal) / along : -1.0f;
+		if (t > 1e-4f && t < nearest && insideTriangle(triangle, origin + t * direction, 0.0f)) {
+			nearest = t;
+			hit = i;
+		}
+		i++;
+	}
+	return nearest != INFINITY;
+}
+
+// Casts a ray from the camera through every 4th pixel of a 320 x 240 image and checks findClosestIntersection
+// against the brute force search, then times it
+void benchmarkRayCasting(const std::string &label, const MeshView &mesh, const glm::vec3 &cameraPos) {
+	std::vector<glm::vec3> directions;
+	for (int y = 0; y < HEIGHT; y += 4) {
+		for (int x = 0; x < WIDTH; x += 4) {
+			directions.push_back(glm::normalize(glm::vec3((x - WIDTH / 2) / 160.0f, (HEIGHT / 2 - y) / 160.0f, -2.0f)));
+		}
+	}
+	size_t hits = 0;
+	size_t mismatches = 0;
+	for (const glm::vec3 &direction : directions) {
+		RayTriangleIntersection found;
+		bool hit = findClosestIntersection(mesh, cameraPos, direction, found);
+		float expectedDistance;
+		size_t expectedTriangle = 0;
+		bool expectedHit = bruteForceIntersection(mesh, cameraPos, direction, expectedDistance, expectedTriangle);
+		bool agrees = hit == expectedHit;
+		if (agrees && hit) {
+			hits++;
+			// Where two triangles meet either can be the one that is hit, but the distance has to be the same
+			// and the point has to be on the triangle that was reported
+			ModelTriangle triangle = mesh.triangle(found.triangleIndex);
+			agrees = std::abs(found.distanceFromCamera - expectedDistance) <= 1e-4f * expectedDistance &&
+			         (found.triangleIndex == expectedTriangle || insideTriangle(triangle, found.intersectionPoint, 1e-4f)) &&
+			         found.intersectedTriangle.vertices == triangle.vertices &&
+			         glm::length(found.intersectionPoint - (cameraPos + expectedDistance * direction)) <= 1e-4f * expectedDistance;
+		}
+		if (!agrees) mismatches++;
+	}
+	if (mismatches > 0) {
+		std::cout << label << " findClosestIntersection disagreed with the brute force search on " << mismatches << " of "
+		          << directions.size() << " rays" << std::endl;
+		checksFailed = true;
+	}
+	double triangles = double(mesh.triangleCount()) * directions.size();
+	measure(label + " findClosestIntersection " + std::to_string(hits) + " hits", triangles, 0, [&](size_t) {
+		RayTriangleIntersection found;
+		for (const glm::vec3 &direction : directions) findClosestIntersection(mesh, cameraPos, direction, found);
+	});
+}
+
+// Loading, projecting and rendering one of the Cornell boxes with the 3DModelling pipeline
+void benchmarkModel(const std::string &label, const std::string &directory, const std::string &model, const std::string &palette) {
+	std::string objPath = directory + "/" + model;
+	std::string mtlPath = directory + "/" + palette;
+	// Loaded once untimed first, so every stage can be given the number of triangles it goes through
+	MaterialTable materials;
+	IndexedMesh mesh;
+	if (!modelling::loadPalette(mtlPath, materials) || !modelling::processOBJFile(objPath, materials, mesh)) {
+		std::cout << label << " couldn't be loaded from " << objPath << ", skipping it" << std::endl;
+		return;
+	}
+	double triangles = mesh.triangleCount();
+	measure(label + " loadPalette", triangles, 0, [&](size_t) { modelling::loadPalette(mtlPath, materials); });
+	measure(label + " processOBJFile", triangles, 0, [&](size_t) { modelling::processOBJFile(objPath, materials, mesh); });
+	glm::vec3 cameraPos(0.0f, 0.0f, 4.0f);
+	float focalLength = 2.0f;
+
+	for (glm::ivec2 size : {glm::ivec2(WIDTH, HEIGHT), glm::ivec2(4 * WIDTH, 4 * HEIGHT)}) {
+		std::string resolution = " " + std::to_string(size.x) + "x" + std::to_string(size.y);
+		double pixels = double(size.x) * size.y;
+		RenderTarget target(size.x, size.y);
+		std::vector<CanvasTriangle> projected;
+		std::vector<uint32_t> colours;
+		measure(label + resolution + " projection", triangles, 0, [&](size_t) {
+			modelling::projectTriangles(target, mesh, cameraPos, focalLength, projected, colours);
+		});
+		measure(label + resolution + " serialRender", triangles, pixels, [&](size_t) {
+			target.clear();
+			modelling::serialRasterisedRender(target, mesh, cameraPos, focalLength);
+		});
+		measure(label + resolution + " rasterisedRender", triangles, pixels, [&](size_t) {
+			target.clear();
+			modelling::rasterisedRender(target, mesh, cameraPos, focalLength);
+		});
+		// The same again with the profiler recording, the difference is what profiling costs
+		modelling::profiler.setEnabled(true);
+		measure(label + resolution + " rasterisedRender profiled", triangles, pixels, [&](size_t) {
+			modelling::profiler.beginFrame();
+			target.clear();
+			modelling::rasterisedRender(target, mesh, cameraPos, focalLength);
+			modelling::profiler.endFrame();
+		});
+		modelling::profiler.setEnabled(false);
+	}
+	benchmarkRayCasting(label, mesh, cameraPos);
+}
+
+// Loading a flat grid of cells x cells squares, two triangles each, written out as an .obj first
+// Parsed on one thread, in parallel chunks, and all the way to an IndexedMesh by processOBJFile, then opened as a SceneBundle
+void benchmarkLargeOBJ(int cells) {
+	std::string path = "RedNoiseBench-grid.obj";
+	std::string bundlePath = "RedNoiseBench-grid.bundle";
+	{
+		std::ofstream output(path);
+		output << "usemtl White\n";
+		char line[96];
+		for (int y = 0; y <= cells; y++) {
+			for (int x = 0; x <= cells; x++) {
+				std::snprintf(line, sizeof(line), "v %.6f %.6f -1.000000\n", 2.0 * x / cells - 1, 2.0 * y / cells - 1);
+				output << line;
+			}
+		}
+		for (int y = 0; y < cells; y++) {
+			for (int x = 0; x < cells; x++) {
+				int corner = y * (cells + 1) + x + 1;
+				output << "f " << corner << " " << corner + 1 << " " << corner + cells + 2 << "\n";
+				output << "f " << corner << " " << corner + cells + 2 << " " << corner + cells + 1 << "\n";
+			}
+		}
+	}
+	double triangles = 2.0 * cells * cells;
+	std::string label = "grid.obj " + std::to_string(int(triangles)) + " triangles";
+	{
+		MappedFile file(path);
+		OBJData data;
+		measure(label + " parseOBJ", triangles, 0, [&](size_t) { parseOBJ(file.data(), file.data() + file.size(), data); });
+		measure(label + " parseOBJ parallel", triangles, 0, [&](size_t) {
+			parseOBJ(file.data(), file.data() + file.size(), data, &modelling::workerPool());
+		});
+		MaterialTable palette;
+		palette.add(Colour("White", 255, 255, 255));
+		IndexedMesh mesh;
+		measure(label + " processOBJFile", triangles, 0, [&](size_t) { modelling::processOBJFile(path, palette, mesh); });
+		// The same mesh saved as a bundle and opened again, which is what startup costs without the .obj
+		std::string error;
+		if (writeSceneBundle(bundlePath, mesh, nullptr, error)) {
+			measure(label + " SceneBundle open", triangles, 0, [&](size_t) {
+				SceneBundle bundle(bundlePath);
+				if (!bundle.isOpen()) std::cerr << bundle.error() << std::endl;
+			});
+		} else {
+			std::cout << label << " couldn't save a bundle (" << error << ")" << std::endl;
+		}
+	}
+	std::remove(path.c_str());
+	std::remove(bundlePath.c_str());
+}
+
+int main(int argc, char *argv[]) {
+	std::string output = (argc > 1) ? argv[1] : "RedNoiseBench.json";
+	std::cout << "fillTriangle kernel: " << rasterKernelName() << " (" << rasterKernelWidth() << " pixels wide)" << std::endl;
+	benchmarkCanvas();
+	benchmarkModel("cornell-box", WORKBOOKS_DIR "/04 Wireframes and Rasterising/models", "cornell-box.obj", "cornell-box.mtl");
+	benchmarkModel("textured-cornell-box", WORKBOOKS_DIR "/05 Navigation and Transformation/models",
+	               "textured-cornell-box.obj", "textured-cornell-box.mtl");
+	benchmarkLargeOBJ(1000);
+	writeJSON(output);
+	std::cout << "Results written to " << output << std::endl;
+	return checksFailed ? 1 : 0;
+}
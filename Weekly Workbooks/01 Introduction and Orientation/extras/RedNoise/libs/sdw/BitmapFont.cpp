@@ -0,0 +1,39 @@
+#include <cstring>
+#include "BitmapFont.h"
+
+// One octal digit per row from top to bottom, within a row 4 is the left pixel, 2 the middle and 1 the right
+static const char GLYPH_CHARACTERS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.,:-/%()=_+";
+static const uint16_t GLYPHS[] = {
+	075557, 026227, 071747, 071317, 055711, 074717, 074757, 071111, 075757, 075717,
+	025755, 065656, 034443, 065556, 074647, 074644, 034553, 055755, 072227, 011152,
+	055655, 044447, 057755, 065555, 025552, 065644, 025563, 065655, 034216, 072222,
+	055557, 055552, 055775, 055255, 055222, 071247,
+	000002, 000024, 002020, 000700, 011244, 051245, 012221, 042224, 007070, 000007, 002720
+};
+
+static uint16_t glyphFor(char c) {
+	if (c >= 'a' && c <= 'z') c = char(c - 'a' + 'A');
+	if (c == '\0') return 0;
+	const char *found = std::strchr(GLYPH_CHARACTERS, c);
+	return found ? GLYPHS[found - GLYPH_CHARACTERS] : 0;
+}
+
+void drawText(DrawingWindow &window, int x, int y, const std::string &text, uint32_t colour, int scale) {
+	for (char c : text) {
+		uint16_t glyph = glyphFor(c);
+		for (int row = 0; glyph && row < GLYPH_HEIGHT; row++) {
+			int bits = (glyph >> (3 * (GLYPH_HEIGHT - 1 - row))) & 7;
+			for (int column = 0; column < GLYPH_WIDTH; column++) {
+				if (!(bits & (4 >> column))) continue;
+				// fillSpan does the clipping, so a glyph half off the window still draws its visible half
+				for (int dy = 0; dy < scale; dy++) window.fillSpan(x + column * scale, y + row * scale + dy, scale, colour);
+			}
+		}
+		x += (GLYPH_WIDTH + 1) * scale;
+	}
+}
+
+int textWidth(const std::string &text, int scale) {
+	if (text.empty()) return 0;
+	return int(text.size()) * (GLYPH_WIDTH + 1) * scale - scale;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "DrawingWindow.h"
+
+// A built-in 3x5 pixel font for drawing text straight into the window, so overlays need no font files
+// It has digits, upper case letters and a little punctuation, lower case is drawn as upper case
+// and anything else as a space. Each character is GLYPH_WIDTH + 1 pixels wide including the gap after it
+const int GLYPH_WIDTH = 3;
+const int GLYPH_HEIGHT = 5;
+
+// Draws text with its top left corner at (x, y), every font pixel scaled up to scale x scale window pixels
+// Clipped to the window, so text can run off any edge
+void drawText(DrawingWindow &window, int x, int y, const std::string &text, uint32_t colour, int scale = 1);
+// Width in window pixels of text drawn at the given scale, not counting the gap after the last character
+int textWidth(const std::string &text, int scale = 1);
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <utility>
+#include "Culling.h"
+#include "IndexedMesh.h"
+
+size_t CullStats::culled() const {
+	return backFacing + outsideFrustum;
+}
+
+size_t CullStats::kept() const {
+	return submitted - culled();
+}
+
+void CullStats::reset() {
+	*this = CullStats();
+}
+
+// In camera space (d = p - camera) a point is inside when -d.z >= near and |d.x|, |d.y| <= half extent * -d.z
+// The plane normals are then turned into world space with the camera's orientation
+static void makePlanes(const glm::vec3 &camera, const glm::mat3 &orientation, float nearDistance, float halfWidth, float halfHeight,
+                       glm::vec4 planes[5]) {
+	glm::vec3 sides[5] = {
+			glm::vec3(0.0f, 0.0f, -1.0f),
+			glm::vec3(1.0f, 0.0f, -halfWidth),
+			glm::vec3(-1.0f, 0.0f, -halfWidth),
+			glm::vec3(0.0f, 1.0f, -halfHeight),
+			glm::vec3(0.0f, -1.0f, -halfHeight)};
+	float distances[5] = {-nearDistance, 0.0f, 0.0f, 0.0f, 0.0f};
+	for (int i = 0; i < 5; i++) {
+		glm::vec3 normal = orientation * sides[i];
+		planes[i] = glm::vec4(normal, distances[i] - glm::dot(normal, camera));
+	}
+}
+
+static float planeDistance(const glm::vec4 &plane, const glm::vec3 &point) {
+	return glm::dot(glm::vec3(plane), point) + plane.w;
+}
+
+ViewFrustum::ViewFrustum(const glm::vec3 &cameraPosition, float focalLength, float imageScale, int width, int height, float nearDistance,
+                         float guardBandScale) :
+		ViewFrustum(cameraPosition, glm::mat3(1.0f), focalLength, imageScale, width, height, nearDistance, guardBandScale) {}
+
+ViewFrustum::ViewFrustum(const glm::vec3 &cameraPosition, const glm::mat3 &cameraOrientation, float focalLength, float imageScale,
+                         int width, int height, float nearDistance, float guardBandScale) :
+		camera(cameraPosition) {
+	// Half the image size in units of the projection scale, with a pixel of slack
+	// so rounding can never cull a triangle that touches the edge of the screen
+	float pixelsPerUnit = imageScale * focalLength;
+	float halfWidth = (width / 2.0f + 1.0f) / pixelsPerUnit;
+	float halfHeight = (height / 2.0f + 1.0f) / pixelsPerUnit;
+	makePlanes(camera, cameraOrientation, nearDistance, halfWidth, halfHeight, viewPlanes);
+	makePlanes(camera, cameraOrientation, nearDistance, halfWidth * guardBandScale, halfHeight * guardBandScale, clipPlanes);
+}
+
+const glm::vec3 &ViewFrustum::cameraPosition() const {
+	return camera;
+}
+
+bool ViewFrustum::isOutside(const ModelTriangle &triangle) const {
+	return isOutside(triangle.vertices[0], triangle.vertices[1], triangle.vertices[2]);
+}
+
+bool ViewFrustum::isOutside(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2) const {
+	for (const glm::vec4 &plane : viewPlanes) {
+		if (planeDistance(plane, v0) < 0.0f && planeDistance(plane, v1) < 0.0f && planeDistance(plane, v2) < 0.0f) return true;
+	}
+	return false;
+}
+
+bool ViewFrustum::isBackFacing(const ModelTriangle &triangle) const {
+	return isBackFacing(triangle.normal, triangle.vertices[0]);
+}
+
+bool ViewFrustum::isBackFacing(const glm::vec3 &normal, const glm::vec3 &vertex) const {
+	return glm::dot(normal, vertex - camera) >= 0.0f;
+}
+
+bool ViewFrustum::needsClipping(const ModelTriangle &triangle) const {
+	return needsClipping(triangle.vertices[0], triangle.vertices[1], triangle.vertices[2]);
+}
+
+bool ViewFrustum::needsClipping(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2) const {
+	for (const glm::vec4 &plane : clipPlanes) {
+		if (planeDistance(plane, v0) < 0.0f || planeDistance(plane, v1) < 0.0f || planeDistance(plane, v2) < 0.0f) return true;
+	}
+	return false;
+}
+
+// A corner of the polygon being clipped
+struct ClipVertex {
+	glm::vec3 position;
+	glm::vec2 texturePoint;
+};
+
+// Each plane can add at most one vertex to a convex polygon, so a triangle never gets past 3 + 5
+static const int MAX_CLIP_VERTICES = 8;
+
+size_t ViewFrustum::clip(const ModelTriangle &triangle, std::vector<ModelTriangle> &out) const {
+	ClipVertex polygon[MAX_CLIP_VERTICES];
+	ClipVertex next[MAX_CLIP_VERTICES];
+	int count = 3;
+	for (int i = 0; i < 3; i++) {
+		polygon[i].position = triangle.vertices[i];
+		polygon[i].texturePoint = glm::vec2(triangle.texturePoints[i].x, triangle.texturePoints[i].y);
+	}
+
+	// Sutherland-Hodgman: keep the corners inside each plane and add one where each edge crosses it
+	for (const glm::vec4 &plane : clipPlanes) {
+		int nextCount = 0;
+		for (int i = 0; i < count; i++) {
+			const ClipVertex &a = polygon[i];
+			const ClipVertex &b = polygon[(i + 1) % count];
+			float distanceA = planeDistance(plane, a.position);
+			float distanceB = planeDistance(plane, b.position);
+			if (distanceA >= 0.0f) next[nextCount++] = a;
+			if ((distanceA >= 0.0f) != (distanceB >= 0.0f)) {
+				float t = distanceA / (distanceA - distanceB);
+				next[nextCount].position = glm::mix(a.position, b.position, t);
+				next[nextCount].texturePoint = glm::mix(a.texturePoint, b.texturePoint, t);
+				nextCount++;
+			}
+		}
+		count = nextCount;
+		std::copy(next, next + count, polygon);
+		if (count < 3) return 0;
+	}
+
+	for (int i = 1; i + 1 < count; i++) {
+		const ClipVertex *corners[3] = {&polygon[0], &polygon[i], &polygon[i + 1]};
+		ModelTriangle piece(corners[0]->position, corners[1]->position, corners[2]->position, triangle.material);
+		for (int j = 0; j < 3; j++) piece.texturePoints[j] = TexturePoint(corners[j]->texturePoint.x, corners[j]->texturePoint.y);
+		piece.normal = triangle.normal;
+		out.push_back(std::move(piece));
+	}
+	return count - 2;
+}
+
+glm::vec3 faceNormal(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2) {
+	glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
+	float length = glm::length(normal);
+	return (length > 0.0f) ? normal / length : normal;
+}
+
+void cullTriangles(const std::vector<ModelTriangle> &triangles, const ViewFrustum &frustum,
+                   std::vector<uint32_t> &visible, std::vector<ModelTriangle> &clipped, CullStats &stats) {
+	visible.clear();
+	clipped.clear();
+	stats.submitted += triangles.size();
+	for (size_t i = 0; i < triangles.size(); i++) {
+		if (frustum.isBackFacing(triangles[i])) {
+			stats.backFacing++;
+		} else if (frustum.isOutside(triangles[i])) {
+			stats.outsideFrustum++;
+		} else if (frustum.needsClipping(triangles[i])) {
+			stats.clipped++;
+			stats.clippedPieces += frustum.clip(triangles[i], clipped);
+		} else {
+			visible.push_back(i);
+		}
+	}
+}
+
+void cullTriangles(const MeshView &mesh, const ViewFrustum &frustum,
+                   std::vector<uint32_t> &visible, std::vector<ModelTriangle> &clipped, CullStats &stats) {
+	visible.clear();
+	clipped.clear();
+	size_t count = mesh.triangleCount();
+	stats.submitted += count;
+	for (size_t i = 0; i < count; i++) {
+		glm::vec3 v0 = mesh.vertices[mesh.indices[3 * i]];
+		glm::vec3 v1 = mesh.vertices[mesh.indices[3 * i + 1]];
+		glm::vec3 v2 = mesh.vertices[mesh.indices[3 * i + 2]];
+		if (frustum.isBackFacing(mesh.normals[i], v0)) {
+			stats.backFacing++;
+		} else if (frustum.isOutside(v0, v1, v2)) {
+			stats.outsideFrustum++;
+		} else if (frustum.needsClipping(v0, v1, v2)) {
+			stats.clipped++;
+			stats.clippedPieces += frustum.clip(mesh.triangle(i), clipped);
+		} else {
+			visible.push_back(i);
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ModelTriangle.h"
+
+struct MeshView;
+
+// How many triangles went into the culling stage and why the rest were thrown away
+struct CullStats {
+	size_t submitted{};
+	size_t backFacing{};
+	size_t outsideFrustum{};
+	// Triangles that crossed the near plane or the guard band, and the pieces they were cut into
+	size_t clipped{};
+	size_t clippedPieces{};
+
+	size_t culled() const;
+	size_t kept() const;
+	void reset();
+};
+
+// The volume a pinhole camera at cameraPosition looking down -z can see, for a projection of
+//   u = -imageScale * focalLength * x / z + width / 2
+//   v =  imageScale * focalLength * y / z + height / 2
+// with x, y, z measured from the camera in its own frame, as in projectVertexOntoCanvasPoint and viewProjectionMatrix
+// The columns of cameraOrientation are the camera's right, up and backward directions, without it the camera looks down -z
+// Points closer to the camera than nearDistance are outside it
+// The guard band is a wider version of the same volume, guardBandScale times the size of the screen, that
+// triangles are clipped to, so projected coordinates stay small enough to rasterise without precision problems
+// while triangles that only poke a little way off the screen don't need clipping at all
+class ViewFrustum {
+public:
+	ViewFrustum(const glm::vec3 &cameraPosition, float focalLength, float imageScale, int width, int height, float nearDistance,
+	            float guardBandScale = 4.0f);
+	ViewFrustum(const glm::vec3 &cameraPosition, const glm::mat3 &cameraOrientation, float focalLength, float imageScale,
+	            int width, int height, float nearDistance, float guardBandScale = 4.0f);
+
+	const glm::vec3 &cameraPosition() const;
+	// True if all three vertices are on the outside of the same plane, so none of the triangle is visible
+	// Triangles that only cross a plane are kept
+	bool isOutside(const ModelTriangle &triangle) const;
+	bool isOutside(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2) const;
+	// True if the triangle's normal points away from the camera (or along the line of sight)
+	bool isBackFacing(const ModelTriangle &triangle) const;
+	bool isBackFacing(const glm::vec3 &normal, const glm::vec3 &vertex) const;
+	// True if any vertex is in front of the near plane or outside the guard band
+	bool needsClipping(const ModelTriangle &triangle) const;
+	bool needsClipping(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2) const;
+	// Cuts the triangle down to the part inside the near plane and the guard band and appends it to out
+	// as a fan of triangles with the same material and normal and interpolated texture points
+	// Returns how many triangles were appended (0 if nothing was left)
+	size_t clip(const ModelTriangle &triangle, std::vector<ModelTriangle> &out) const;
+
+private:
+	glm::vec3 camera;
+	// Each plane is (normal, offset) with normal . p + offset >= 0 on the inside
+	// The view planes decide what is culled and the clip planes what is cut, both start with the near plane
+	glm::vec4 viewPlanes[5];
+	glm::vec4 clipPlanes[5];
+};
+
+// The face normal of the triangle, taking counter-clockwise winding as the front
+glm::vec3 faceNormal(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2);
+
+// Writes the indices of the triangles that face the camera and are at least partly inside the frustum
+// to visible, in their original order, and adds what happened to stats
+// Visible triangles that need clipping go to clipped (as their clipped pieces) instead of visible
+void cullTriangles(const std::vector<ModelTriangle> &triangles, const ViewFrustum &frustum,
+                   std::vector<uint32_t> &visible, std::vector<ModelTriangle> &clipped, CullStats &stats);
+// The same for the triangles of an indexed mesh (or an IndexedMesh, which converts to one), visible gets triangle numbers
+void cullTriangles(const MeshView &mesh, const ViewFrustum &frustum,
+                   std::vector<uint32_t> &visible, std::vector<ModelTriangle> &clipped, CullStats &stats);
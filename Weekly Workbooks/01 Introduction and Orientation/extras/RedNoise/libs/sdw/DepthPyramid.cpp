@@ -0,0 +1,101 @@
+#include <algorithm>
+#include "DepthPyramid.h"
+
+constexpr int DepthPyramid::CELL_SIZE;
+
+DepthPyramid::DepthPyramid(size_t w, size_t h) : width(w), height(h) {
+	int size = CELL_SIZE;
+	while (true) {
+		int x = (w + size - 1) / size;
+		int y = (h + size - 1) / size;
+		cellsX.push_back(x);
+		cellsY.push_back(y);
+		levels.emplace_back(x * y, 0.0f);
+		if (x <= 1 && y <= 1) break;
+		size *= 2;
+	}
+}
+
+void DepthPyramid::clear(float depth) {
+	for (std::vector<float> &level : levels) std::fill(level.begin(), level.end(), depth);
+}
+
+int DepthPyramid::levelCount() const {
+	return levels.size();
+}
+
+int DepthPyramid::cellSize(int level) const {
+	return CELL_SIZE << level;
+}
+
+float DepthPyramid::farthestDepth(int level, int cellX, int cellY) const {
+	return levels[level][cellY * cellsX[level] + cellX];
+}
+
+bool DepthPyramid::isOccluded(const PixelRect &area, float nearestDepth, int maxLevel) const {
+	PixelRect screen(0, 0, int(width) - 1, int(height) - 1);
+	PixelRect visible = area.intersect(screen);
+	if (visible.isEmpty()) return true;
+	// Use the finest level where the area only touches a couple of cells each way
+	int level = 0;
+	maxLevel = std::min(maxLevel, levelCount() - 1);
+	while (level < maxLevel) {
+		int size = cellSize(level);
+		if ((visible.maxX / size - visible.minX / size) <= 1 && (visible.maxY / size - visible.minY / size) <= 1) break;
+		level++;
+	}
+	int size = cellSize(level);
+	for (int cellY = visible.minY / size; cellY <= visible.maxY / size; cellY++) {
+		for (int cellX = visible.minX / size; cellX <= visible.maxX / size; cellX++) {
+			if (nearestDepth > farthestDepth(level, cellX, cellY)) return false;
+		}
+	}
+	return true;
+}
+
+bool DepthPyramid::isOccluded(const PixelRect &area, float nearestDepth) const {
+	return isOccluded(area, nearestDepth, levelCount() - 1);
+}
+
+void DepthPyramid::updateCell(const RasterBuffer &source, int cellX, int cellY) {
+	int left = cellX * CELL_SIZE;
+	int top = cellY * CELL_SIZE;
+	int right = std::min(left + CELL_SIZE, int(width));
+	int bottom = std::min(top + CELL_SIZE, int(height));
+	float farthest = source.depth[(top - source.originY) * source.stride + (left - source.originX)];
+	for (int y = top; y < bottom; y++) {
+		const float *row = source.depth + (y - source.originY) * source.stride + (left - source.originX);
+		for (int x = 0; x < right - left; x++) farthest = std::min(farthest, row[x]);
+	}
+	levels[0][cellY * cellsX[0] + cellX] = farthest;
+}
+
+void DepthPyramid::propagate(const PixelRect &area, int maxLevel) {
+	PixelRect screen(0, 0, int(width) - 1, int(height) - 1);
+	PixelRect visible = area.intersect(screen);
+	if (visible.isEmpty()) return;
+	maxLevel = std::min(maxLevel, levelCount() - 1);
+	for (int level = 1; level <= maxLevel; level++) {
+		int size = cellSize(level);
+		const std::vector<float> &below = levels[level - 1];
+		int belowX = cellsX[level - 1];
+		int belowY = cellsY[level - 1];
+		for (int cellY = visible.minY / size; cellY <= visible.maxY / size; cellY++) {
+			for (int cellX = visible.minX / size; cellX <= visible.maxX / size; cellX++) {
+				int childX = cellX * 2;
+				int childY = cellY * 2;
+				float farthest = below[childY * belowX + childX];
+				if (childX + 1 < belowX) farthest = std::min(farthest, below[childY * belowX + childX + 1]);
+				if (childY + 1 < belowY) {
+					farthest = std::min(farthest, below[(childY + 1) * belowX + childX]);
+					if (childX + 1 < belowX) farthest = std::min(farthest, below[(childY + 1) * belowX + childX + 1]);
+				}
+				levels[level][cellY * cellsX[level] + cellX] = farthest;
+			}
+		}
+	}
+}
+
+void DepthPyramid::propagate(const PixelRect &area) {
+	propagate(area, levelCount() - 1);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include "Rasteriser.h"
+
+// A coarse copy of a depth buffer: level 0 holds the farthest depth stored in each 8x8 cell,
+// and every level above holds the farthest of the 2x2 cells below it, up to a single cell
+// Depths are 1/z like the depth buffer, so "farthest" is the smallest value
+// A triangle (or part of one) that can't get any closer than a cell's value is completely hidden there
+class DepthPyramid {
+public:
+	static constexpr int CELL_SIZE = 8;
+
+	DepthPyramid(size_t w, size_t h);
+	void clear(float depth = 0.0f);
+	int levelCount() const;
+	int cellSize(int level) const;
+	float farthestDepth(int level, int cellX, int cellY) const;
+
+	// True if nothing at a depth of nearestDepth or less could pass the depth test anywhere in the area
+	// Looks no higher than maxLevel, so callers can keep to the levels they know are up to date
+	bool isOccluded(const PixelRect &area, float nearestDepth, int maxLevel) const;
+	bool isOccluded(const PixelRect &area, float nearestDepth) const;
+	// Recomputes one level 0 cell from the depth values in source, which must cover the whole cell
+	void updateCell(const RasterBuffer &source, int cellX, int cellY);
+	// Recomputes the cells of levels 1 to maxLevel that lie over the area from the level below
+	void propagate(const PixelRect &area, int maxLevel);
+	void propagate(const PixelRect &area);
+
+private:
+	size_t width;
+	size_t height;
+	std::vector<int> cellsX;
+	std::vector<int> cellsY;
+	std::vector<std::vector<float>> levels;
+};
@@ -0,0 +1,39 @@
+#include "DrawingThread.h"
+
+DrawingThread::DrawingThread(std::function<void()> draw) : draw(std::move(draw)), thread(&DrawingThread::drawLoop, this) {}
+
+DrawingThread::~DrawingThread() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_one();
+	thread.join();
+}
+
+void DrawingThread::request() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		requested++;
+	}
+	wake.notify_one();
+}
+
+void DrawingThread::wait() {
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [&] { return drawn == requested; });
+}
+
+void DrawingThread::drawLoop() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [&] { return stopping || drawn != requested; });
+		// Requests that came in before stopping are still drawn, so wait() never blocks forever
+		if (drawn == requested) return;
+		lock.unlock();
+		draw();
+		lock.lock();
+		drawn++;
+		finished.notify_all();
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// One thread that stays up for the life of the program and draws a frame each time it is asked to,
+// so the thread that made the window can present the previous frame in the meantime
+// Whatever draw reads can't be changed until wait() has returned, nor the window's pixels looked at
+//
+//	drawer.request();
+//	scheduler.presentQueued();
+//	drawer.wait();
+class DrawingThread {
+public:
+	explicit DrawingThread(std::function<void()> draw);
+	// Finishes the frame being drawn, if there is one, before stopping the thread
+	~DrawingThread();
+	DrawingThread(const DrawingThread &) = delete;
+	DrawingThread &operator=(const DrawingThread &) = delete;
+
+	// Starts drawing a frame and returns straight away, a request made while one is being drawn waits for it
+	void request();
+	// Blocks until every requested frame has been drawn
+	void wait();
+
+private:
+	std::function<void()> draw;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable finished;
+	size_t requested = 0;
+	size_t drawn = 0;
+	bool stopping = false;
+	std::thread thread;
+
+	void drawLoop();
+};
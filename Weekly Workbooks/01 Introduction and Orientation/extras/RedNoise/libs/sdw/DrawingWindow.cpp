@@ -1,34 +1,60 @@
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include "DrawingWindow.h"
 // On some platforms you may need to include <cstring> (if you compiler can't find memset !)
 
 DrawingWindow::DrawingWindow() {}
 
-DrawingWindow::DrawingWindow(int w, int h, bool fullscreen) : width(w), height(h), pixelBuffer(w * h) {
+DrawingWindow::DrawingWindow(int w, int h, bool fullscreen, bool vsync) : width(w), height(h), pixelBuffer(w * h) {
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) printMessageAndQuit("Could not initialise SDL: ", SDL_GetError());
 	uint32_t flags = SDL_WINDOW_OPENGL;
 	if (fullscreen) flags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
 	int ANYWHERE = SDL_WINDOWPOS_UNDEFINED;
 	window = SDL_CreateWindow("COMS30020", ANYWHERE, ANYWHERE, width, height, flags);
 	if (!window) printMessageAndQuit("Could not set video mode: ", SDL_GetError());
-	// Set rendering to software (hardware acceleration doesn't work on all platforms)
-	flags = SDL_RENDERER_SOFTWARE;
-	// You could try hardware acceleration if you like - by uncommenting the below line
-	// flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
-	renderer = SDL_CreateRenderer(window, -1, flags);
-	if (!renderer) printMessageAndQuit("Could not create renderer: ", SDL_GetError());
-	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
-	SDL_RenderSetLogicalSize(renderer, width, height);
-	int PIXELFORMAT = SDL_PIXELFORMAT_ARGB8888;
-	texture = SDL_CreateTexture(renderer, PIXELFORMAT, SDL_TEXTUREACCESS_STATIC, width, height);
-	if (!texture) printMessageAndQuit("Could not allocate texture: ", SDL_GetError());
+	// The renderer and texture are made here on the main thread, where SDL needs every render call to happen
+	presenter.reset(new FramePresenter(window, width, height, vsync));
+	if (presenter->failure()) printMessageAndQuit(presenter->failure(), presenter->failureReason().c_str());
+}
+
+DrawingWindow DrawingWindow::offscreen(int w, int h) {
+	// No SDL_Init, window or renderer, so this works on machines without a display
+	DrawingWindow offscreenWindow;
+	offscreenWindow.width = w;
+	offscreenWindow.height = h;
+	offscreenWindow.pixelBuffer.resize(w * h);
+	return offscreenWindow;
+}
+
+bool DrawingWindow::isOffscreen() const {
+	return window == nullptr;
 }
 
 void DrawingWindow::renderFrame() {
-	SDL_UpdateTexture(texture, nullptr, pixelBuffer.data(), width * sizeof(uint32_t));
-	SDL_RenderClear(renderer);
-	SDL_RenderCopy(renderer, texture, nullptr, nullptr);
-	SDL_RenderPresent(renderer);
+	queueFrame();
+	presentQueuedFrame();
+}
+
+void DrawingWindow::queueFrame() {
+	if (presenter) presenter->queue(pixelBuffer.data());
+	dirty = false;
+}
+
+bool DrawingWindow::presentQueuedFrame() {
+	return presenter && presenter->presentQueued();
+}
+
+bool DrawingWindow::hasQueuedFrame() const {
+	return presenter && presenter->hasQueued();
+}
+
+void DrawingWindow::markDirty() {
+	dirty = true;
+}
+
+bool DrawingWindow::isDirty() const {
+	return dirty;
 }
 
 void DrawingWindow::saveBMP(const std::string &filename) const {
@@ -36,6 +62,7 @@ void DrawingWindow::saveBMP(const std::string &filename) const {
 	                                        width * sizeof(uint32_t),
 	                                        0xFF << 16, 0xFF << 8, 0xFF << 0, 0xFF << 24);
 	SDL_SaveBMP(surface, filename.c_str());
+	SDL_FreeSurface(surface);
 }
 
 void DrawingWindow::savePPM(const std::string &filename) const {
@@ -57,42 +84,135 @@ void DrawingWindow::savePPM(const std::string &filename) const {
 
 void DrawingWindow::exitCleanly()
 {
-	SDL_DestroyTexture(texture);
-	SDL_DestroyRenderer(renderer);
-	SDL_DestroyWindow(window);
-	SDL_Quit();
+	if (window) {
+		presenter->stop();
+		SDL_DestroyWindow(window);
+		SDL_Quit();
+	}
 	printMessageAndQuit("Exiting", nullptr);
 }
 
 bool DrawingWindow::pollForInputEvents(SDL_Event &event) {
-	if (SDL_PollEvent(&event)) {
-		if (event.type == SDL_QUIT) exitCleanly();
-		else if ((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_ESCAPE)) exitCleanly();
-		else if ((event.type == SDL_WINDOWEVENT) && (event.window.event == SDL_WINDOWEVENT_CLOSE)) exitCleanly();
+	if (window && SDL_PollEvent(&event)) {
+		handleInputEvent(event);
 		SDL_Event dummy;
 		// Clear the event queue by getting all available events
 		// This seems like bad practice (because it will skip some events) however preventing backlog is paramount !
+		// (pollForInputEvents(std::vector<SDL_Event> &) gets the whole backlog without losing any of it)
 		while (SDL_PollEvent(&dummy));
 		return true;
 	}
 	return false;
 }
 
+bool DrawingWindow::pollForInputEvents(std::vector<SDL_Event> &events) {
+	if (closeRequested) exitCleanly();
+	events.clear();
+	if (window) takeQueuedEvents(events);
+	return !events.empty();
+}
+
+bool DrawingWindow::waitForInputEvents(std::vector<SDL_Event> &events, int timeout) {
+	if (closeRequested) exitCleanly();
+	events.clear();
+	// An offscreen window never gets any input, so there is nothing to wait for
+	if (!window) return false;
+	SDL_Event first;
+	if (timeout < 0 ? SDL_WaitEvent(&first) : SDL_WaitEventTimeout(&first, timeout)) {
+		batchInputEvent(first, events);
+	}
+	takeQueuedEvents(events);
+	return !events.empty();
+}
+
+void DrawingWindow::takeQueuedEvents(std::vector<SDL_Event> &events) {
+	SDL_PumpEvents();
+	// Take the queue a chunk at a time rather than pumping the OS once per event like SDL_PollEvent does
+	SDL_Event chunk[64];
+	int count;
+	while ((count = SDL_PeepEvents(chunk, 64, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT)) > 0) {
+		for (int i = 0; i < count; i++) batchInputEvent(chunk[i], events);
+	}
+}
+
+void DrawingWindow::batchInputEvent(const SDL_Event &event, std::vector<SDL_Event> &events) {
+	// Quitting straight away would lose the events before this one in the batch,
+	// so the application gets to handle them all and the window closes on the next call
+	if (isCloseRequest(event)) closeRequested = true;
+	else handleInputEvent(event);
+	events.push_back(event);
+}
+
+bool DrawingWindow::isCloseRequest(const SDL_Event &event) {
+	if (event.type == SDL_QUIT) return true;
+	if ((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_ESCAPE)) return true;
+	return (event.type == SDL_WINDOWEVENT) && (event.window.event == SDL_WINDOWEVENT_CLOSE);
+}
+
+void DrawingWindow::handleInputEvent(const SDL_Event &event) {
+	if (isCloseRequest(event)) exitCleanly();
+	// The window system may have thrown away what was on screen, so it has to be presented again
+	else if ((event.type == SDL_WINDOWEVENT) && (event.window.event == SDL_WINDOWEVENT_EXPOSED)) dirty = true;
+}
+
+// Off screen accesses are only reported in debug builds, flushing stdout for every pixel of a
+// triangle hanging off the edge of the window made release builds crawl
 void DrawingWindow::setPixelColour(size_t x, size_t y, uint32_t colour) {
 	if ((x >= width) || (y >= height)) {
+#ifndef NDEBUG
 		std::cout << x << "," << y << " not on visible screen area" << std::endl;
-	} else pixelBuffer[(y * width) + x] = colour;
+#endif
+	} else {
+		pixelBuffer[(y * width) + x] = colour;
+		dirty = true;
+	}
 }
 
 uint32_t DrawingWindow::getPixelColour(size_t x, size_t y) {
 	if ((x >= width) || (y >= height)) {
+#ifndef NDEBUG
 		std::cout << x << "," << y << " not on visible screen area" << std::endl;
+#endif
 		return -1;
 	} else return pixelBuffer[(y * width) + x];
 }
 
+uint32_t *DrawingWindow::getPixelBuffer() {
+	dirty = true;
+	return pixelBuffer.data();
+}
+
+uint32_t *DrawingWindow::getRow(size_t y) {
+	assert(y < height);
+	dirty = true;
+	return pixelBuffer.data() + y * width;
+}
+
+void DrawingWindow::fillSpan(int x, int y, int count, uint32_t colour) {
+	if (y < 0 || y >= int(height)) return;
+	int first = std::max(x, 0);
+	int last = std::min(x + count, int(width));
+	if (first >= last) return;
+	std::fill(getRow(y) + first, getRow(y) + last, colour);
+}
+
+void DrawingWindow::writeRow(int x, int y, const uint32_t *colours, int count) {
+	if (y < 0 || y >= int(height)) return;
+	int first = std::max(x, 0);
+	int last = std::min(x + count, int(width));
+	if (first >= last) return;
+	std::copy(colours + (first - x), colours + (last - x), getRow(y) + first);
+}
+
+void DrawingWindow::blit(int x, int y, const uint32_t *pixels, size_t w, size_t h, size_t stride) {
+	int firstRow = std::max(y, 0);
+	int lastRow = std::min(y + int(h), int(height));
+	for (int row = firstRow; row < lastRow; row++) writeRow(x, row, pixels + (row - y) * stride, int(w));
+}
+
 void DrawingWindow::clearPixels() {
 	std::fill(pixelBuffer.begin(), pixelBuffer.end(), 0);
+	dirty = true;
 }
 
 void printMessageAndQuit(const std::string &message, const char *error) {
@@ -2,8 +2,10 @@
 
 #include <iostream>
 #include <fstream>
+#include <memory>
 #include <vector>
 #include "SDL.h"
+#include "FramePresenter.h"
 
 class DrawingWindow {
 
@@ -12,21 +14,66 @@ public:
 	size_t height;
 
 private:
-	SDL_Window *window;
-	SDL_Renderer *renderer;
-	SDL_Texture *texture;
+	SDL_Window *window = nullptr;
+	std::unique_ptr<FramePresenter> presenter;
+	// Set by anything that may have changed the pixels since the last renderFrame
+	bool dirty = true;
 	std::vector<uint32_t> pixelBuffer;
 
+	// A quit, escape or close event has been handed out in a batch, the window closes at the next poll
+	bool closeRequested = false;
+
+	static bool isCloseRequest(const SDL_Event &event);
+	void handleInputEvent(const SDL_Event &event);
+	void batchInputEvent(const SDL_Event &event, std::vector<SDL_Event> &events);
+	void takeQueuedEvents(std::vector<SDL_Event> &events);
+
 public:
 	DrawingWindow();
-	DrawingWindow(int w, int h, bool fullscreen);
+	// vsync presents through an accelerated renderer in step with the display instead of the software one
+	DrawingWindow(int w, int h, bool fullscreen, bool vsync = false);
+	// A window that only exists in memory, for batch jobs and benchmarks. It never touches SDL's video subsystem:
+	// renderFrame just clears the dirty flag, there are never any input events and savePPM/saveBMP work as usual
+	static DrawingWindow offscreen(int w, int h);
+	bool isOffscreen() const;
+	// Puts the pixels on screen, queueFrame followed by presentQueuedFrame
 	void renderFrame();
+	// Copies the pixels into the presenter's swap buffers, after which they can be drawn over straight away
+	void queueFrame();
+	// Uploads and presents the last queued frame, returns false if there wasn't one
+	// Has to be called on the thread that made the window, but the next frame can be drawn on others meanwhile
+	bool presentQueuedFrame();
+	// Whether a frame has been queued since the last one was presented, can be asked from any thread
+	bool hasQueuedFrame() const;
+	// Whether the pixels may have changed since they were last presented. Every drawing call sets this,
+	// as do getPixelBuffer and getRow since whatever is written through their pointers can't be seen
+	bool isDirty() const;
+	void markDirty();
 	void savePPM(const std::string &filename) const;
 	void saveBMP(const std::string &filename) const;
+	// Returns one event and throws away any others that are queued up behind it
 	bool pollForInputEvents(SDL_Event &event);
+	// Replaces the contents of events with every event queued since the last call, oldest first, and returns whether there were any
+	// Nothing is dropped, so a slow frame can apply all of its input in one go (event.common.timestamp says when each arrived)
+	bool pollForInputEvents(std::vector<SDL_Event> &events);
+	// Like pollForInputEvents but if nothing is queued sleeps until an event arrives,
+	// giving up after timeout milliseconds (never if negative)
+	bool waitForInputEvents(std::vector<SDL_Event> &events, int timeout);
 	void exitCleanly();
 	void setPixelColour(size_t x, size_t y, uint32_t colour);
 	uint32_t getPixelColour(size_t x, size_t y);
+	// Direct access to the width * height row-major ARGB pixels, with no bounds checking
+	uint32_t *getPixelBuffer();
+	// Pointer to the first pixel of row y, with no bounds checking (asserted in debug builds)
+	uint32_t *getRow(size_t y);
+	// Bulk writes, each clipped to the window once per call. Pixels that fall off screen are dropped,
+	// and unlike setPixelColour nothing is ever printed about them
+	// Sets count pixels of row y, starting at x, to colour
+	void fillSpan(int x, int y, int count, uint32_t colour);
+	// Copies count pixels into row y, starting at x
+	void writeRow(int x, int y, const uint32_t *colours, int count);
+	// Copies a w * h block of pixels whose rows are stride apart, putting its top left corner at (x, y)
+	void blit(int x, int y, const uint32_t *pixels, size_t w, size_t h, size_t stride);
 	void clearPixels();
 };
 
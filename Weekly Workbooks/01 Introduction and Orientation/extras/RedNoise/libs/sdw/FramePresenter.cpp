@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cstring>
+#include "FramePresenter.h"
+
+FramePresenter::FramePresenter(SDL_Window *window, size_t width, size_t height, bool vsync) :
+		width(width), height(height) {
+	for (std::vector<uint32_t> &frame : frames) frame.resize(width * height);
+	// Set rendering to software by default (hardware acceleration doesn't work on all platforms)
+	uint32_t flags = vsync ? (SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC) : SDL_RENDERER_SOFTWARE;
+	renderer = SDL_CreateRenderer(window, -1, flags);
+	if (!renderer) {
+		failureMessage = "Could not create renderer: ";
+		failureDetail = SDL_GetError();
+		return;
+	}
+	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+	SDL_RenderSetLogicalSize(renderer, width, height);
+	texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+	if (!texture) {
+		failureMessage = "Could not allocate texture: ";
+		failureDetail = SDL_GetError();
+	}
+}
+
+FramePresenter::~FramePresenter() {
+	stop();
+}
+
+const char *FramePresenter::failure() const {
+	return failureMessage;
+}
+
+const std::string &FramePresenter::failureReason() const {
+	return failureDetail;
+}
+
+void FramePresenter::queue(const uint32_t *pixels) {
+	int frame;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// Of the three buffers at most one is waiting and one is on its way to the screen, so one is always free
+		frame = 0;
+		while (frame == readyFrame || frame == presentingFrame) frame++;
+	}
+	std::copy_n(pixels, width * height, frames[frame].data());
+	std::lock_guard<std::mutex> lock(mutex);
+	if (readyFrame != NO_FRAME) dropped++;
+	readyFrame = frame;
+}
+
+bool FramePresenter::presentQueued() {
+	if (!texture) return false;
+	int frame;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (readyFrame == NO_FRAME) return false;
+		frame = readyFrame;
+		readyFrame = NO_FRAME;
+		presentingFrame = frame;
+	}
+	void *texturePixels;
+	int pitch;
+	if (SDL_LockTexture(texture, nullptr, &texturePixels, &pitch) == 0) {
+		// The texture's rows may be padded, so copy row by row
+		const uint32_t *source = frames[frame].data();
+		for (size_t y = 0; y < height; y++) {
+			std::memcpy(static_cast<uint8_t *>(texturePixels) + y * pitch, source + y * width, width * sizeof(uint32_t));
+		}
+		SDL_UnlockTexture(texture);
+	}
+	SDL_RenderClear(renderer);
+	SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+	SDL_RenderPresent(renderer);
+	std::lock_guard<std::mutex> lock(mutex);
+	presentingFrame = NO_FRAME;
+	presented++;
+	return true;
+}
+
+bool FramePresenter::hasQueued() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return readyFrame != NO_FRAME;
+}
+
+void FramePresenter::stop() {
+	if (texture) SDL_DestroyTexture(texture);
+	if (renderer) SDL_DestroyRenderer(renderer);
+	texture = nullptr;
+	renderer = nullptr;
+}
+
+size_t FramePresenter::presentedFrames() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return presented;
+}
+
+size_t FramePresenter::droppedFrames() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return dropped;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "SDL.h"
+
+// Puts finished frames on screen through a streaming texture, with three swap buffers between drawing and presenting
+// queue() copies a frame into a free swap buffer and returns straight away, and can be called from any thread.
+// If the previous frame hasn't been presented yet it is dropped in favour of the newer one
+// SDL's render API has to stay on the thread that made the window, so the renderer is created in the constructor
+// and presentQueued() must be called on that same thread. Uploading and presenting frame N overlaps with drawing
+// frame N + 1 when the next frame is drawn on other threads (e.g. a worker pool) while presentQueued() runs
+class FramePresenter {
+public:
+	// vsync asks for an accelerated renderer that presents in step with the display,
+	// otherwise frames go through the software renderer as soon as they are ready
+	FramePresenter(SDL_Window *window, size_t width, size_t height, bool vsync);
+	~FramePresenter();
+	FramePresenter(const FramePresenter &) = delete;
+	FramePresenter &operator=(const FramePresenter &) = delete;
+
+	// Null once the renderer is up, otherwise what went wrong (with SDL's reason in failureReason)
+	const char *failure() const;
+	const std::string &failureReason() const;
+	// Queues a copy of the width * height row-major ARGB pixels to be shown
+	void queue(const uint32_t *pixels);
+	// Uploads and presents the newest queued frame, returns false if nothing was queued
+	bool presentQueued();
+	// Whether a queued frame is waiting for presentQueued
+	bool hasQueued();
+	// Destroys the renderer, on the thread that created it
+	void stop();
+	size_t presentedFrames();
+	size_t droppedFrames();
+
+private:
+	static const int NO_FRAME = -1;
+
+	size_t width;
+	size_t height;
+	SDL_Renderer *renderer = nullptr;
+	SDL_Texture *texture = nullptr;
+	std::array<std::vector<uint32_t>, 3> frames;
+	std::mutex mutex;
+	int readyFrame = NO_FRAME;
+	int presentingFrame = NO_FRAME;
+	size_t presented = 0;
+	size_t dropped = 0;
+	const char *failureMessage = nullptr;
+	std::string failureDetail;
+};
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include "BitmapFont.h"
+#include "FrameProfiler.h"
+
+double FrameProfiler::Frame::overdraw() const {
+	if (counters[PIXELS_COVERED] == 0) return 0;
+	return double(counters[PIXELS_WRITTEN]) / double(counters[PIXELS_COVERED]);
+}
+
+bool FrameProfiler::isEnabled() const {
+	return enabled;
+}
+
+void FrameProfiler::setEnabled(bool on) {
+	if (on && !enabled) frames.clear();
+	enabled = on;
+	inFrame = false;
+}
+
+void FrameProfiler::beginFrame() {
+	if (!enabled) return;
+	current = Frame();
+	inFrame = true;
+	frameStart = Clock::now();
+}
+
+void FrameProfiler::endFrame() {
+	if (!inFrame) return;
+	current.frameTime = std::chrono::duration<double>(Clock::now() - frameStart).count();
+	inFrame = false;
+	// Dropping half at a time keeps the cost of erasing from the front down to a copy every MAX_HISTORY / 2 frames
+	if (frames.size() >= MAX_HISTORY) frames.erase(frames.begin(), frames.begin() + MAX_HISTORY / 2);
+	frames.push_back(current);
+}
+
+void FrameProfiler::addTime(Stage stage, double seconds) {
+	if (inFrame) current.stageTimes[stage] += seconds;
+}
+
+void FrameProfiler::count(Counter counter, uint64_t amount) {
+	if (inFrame) current.counters[counter] += amount;
+}
+
+size_t FrameProfiler::frameCount() const {
+	return frames.size();
+}
+
+const FrameProfiler::Frame &FrameProfiler::lastFrame() const {
+	static const Frame empty;
+	return frames.empty() ? empty : frames.back();
+}
+
+double FrameProfiler::frameTimePercentile(double percentile, size_t recent) const {
+	if (frames.empty()) return 0;
+	size_t first = (recent == 0 || recent >= frames.size()) ? 0 : frames.size() - recent;
+	std::vector<double> times;
+	times.reserve(frames.size() - first);
+	for (size_t i = first; i < frames.size(); i++) times.push_back(frames[i].frameTime);
+	// Nearest rank, so the result is always one of the recorded times
+	double rank = std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100.0 * times.size());
+	size_t index = std::min(times.size() - 1, size_t(std::max(rank, 1.0)) - 1);
+	std::nth_element(times.begin(), times.begin() + index, times.end());
+	return times[index];
+}
+
+const char *FrameProfiler::stageName(Stage stage) {
+	static const char *names[STAGE_COUNT] = {"cull", "project", "rasterise", "texture", "present"};
+	return names[stage];
+}
+
+const char *FrameProfiler::counterName(Counter counter) {
+	static const char *names[COUNTER_COUNT] = {"triangles_in", "triangles_culled", "triangles_drawn",
+	                                           "pixels_tested", "pixels_written", "pixels_covered"};
+	return names[counter];
+}
+
+bool FrameProfiler::writeLog(const std::string &filename) const {
+	std::ofstream output(filename);
+	if (!output) return false;
+	bool csv = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0;
+	if (csv) {
+		output << "frame,frame_ms";
+		for (int s = 0; s < STAGE_COUNT; s++) output << "," << stageName(Stage(s)) << "_ms";
+		for (int c = 0; c < COUNTER_COUNT; c++) output << "," << counterName(Counter(c));
+		output << ",overdraw\n";
+		for (size_t i = 0; i < frames.size(); i++) {
+			const Frame &frame = frames[i];
+			output << i << "," << frame.frameTime * 1e3;
+			for (int s = 0; s < STAGE_COUNT; s++) output << "," << frame.stageTimes[s] * 1e3;
+			for (int c = 0; c < COUNTER_COUNT; c++) output << "," << frame.counters[c];
+			output << "," << frame.overdraw() << "\n";
+		}
+		return bool(output);
+	}
+	output << "{\n  \"frames\": " << frames.size() << ",\n  \"frame_ms\": {\"p50\": " << frameTimePercentile(50) * 1e3
+	       << ", \"p95\": " << frameTimePercentile(95) * 1e3 << ", \"p99\": " << frameTimePercentile(99) * 1e3
+	       << "},\n  \"log\": [\n";
+	for (size_t i = 0; i < frames.size(); i++) {
+		const Frame &frame = frames[i];
+		output << "    {\"frame_ms\": " << frame.frameTime * 1e3;
+		for (int s = 0; s < STAGE_COUNT; s++) output << ", \"" << stageName(Stage(s)) << "_ms\": " << frame.stageTimes[s] * 1e3;
+		for (int c = 0; c < COUNTER_COUNT; c++) output << ", \"" << counterName(Counter(c)) << "\": " << frame.counters[c];
+		output << ", \"overdraw\": " << frame.overdraw() << "}" << (i + 1 < frames.size() ? ",\n" : "\n");
+	}
+	output << "  ]\n}\n";
+	return bool(output);
+}
+
+void FrameProfiler::drawHUD(DrawingWindow &window) const {
+	const Frame &frame = lastFrame();
+	// Percentiles over the last second or so, so they follow what is on screen now
+	const size_t recent = 60;
+	char lines[4][128];
+	std::snprintf(lines[0], sizeof(lines[0]), "FRAME %.2f MS  P50 %.2f  P95 %.2f  P99 %.2f", frame.frameTime * 1e3,
+	              frameTimePercentile(50, recent) * 1e3, frameTimePercentile(95, recent) * 1e3, frameTimePercentile(99, recent) * 1e3);
+	std::snprintf(lines[1], sizeof(lines[1]), "CULL %.2f  PROJECT %.2f  RASTER %.2f  TEXTURE %.2f  PRESENT %.2f",
+	              frame.stageTimes[CULL] * 1e3, frame.stageTimes[PROJECT] * 1e3, frame.stageTimes[RASTERISE] * 1e3,
+	              frame.stageTimes[TEXTURE] * 1e3, frame.stageTimes[PRESENT] * 1e3);
+	std::snprintf(lines[2], sizeof(lines[2]), "TRIANGLES %llu IN  %llu CULLED  %llu DRAWN",
+	              (unsigned long long)frame.counters[TRIANGLES_IN], (unsigned long long)frame.counters[TRIANGLES_CULLED],
+	              (unsigned long long)frame.counters[TRIANGLES_DRAWN]);
+	std::snprintf(lines[3], sizeof(lines[3]), "PIXELS %llu TESTED  %llu WRITTEN  OVERDRAW %.2f",
+	              (unsigned long long)frame.counters[PIXELS_TESTED], (unsigned long long)frame.counters[PIXELS_WRITTEN], frame.overdraw());
+
+	int scale = window.width >= 640 ? 2 : 1;
+	int margin = 2 * scale;
+	int lineHeight = (GLYPH_HEIGHT + 2) * scale;
+	int boxWidth = 0;
+	for (const char *line : lines) boxWidth = std::max(boxWidth, textWidth(line, scale));
+	boxWidth = std::min(boxWidth + 2 * margin, int(window.width));
+	int boxHeight = std::min(4 * lineHeight + 2 * margin - 2 * scale, int(window.height));
+
+	// Halving every channel keeps the scene visible behind the text
+	for (int y = 0; y < boxHeight; y++) {
+		uint32_t *row = window.getRow(y);
+		for (int x = 0; x < boxWidth; x++) row[x] = 0xFF000000 | ((row[x] >> 1) & 0x7F7F7F);
+	}
+	for (int i = 0; i < 4; i++) drawText(window, margin, margin + i * lineHeight, lines[i], 0xFFFFFF00, scale);
+}
+
+ScopedStageTimer::ScopedStageTimer(FrameProfiler &profiler, FrameProfiler::Stage stage) :
+		profiler(profiler), stage(stage), timing(profiler.isEnabled()) {
+	if (timing) start = FrameProfiler::Clock::now();
+}
+
+ScopedStageTimer::~ScopedStageTimer() {
+	if (timing) profiler.addTime(stage, std::chrono::duration<double>(FrameProfiler::Clock::now() - start).count());
+}
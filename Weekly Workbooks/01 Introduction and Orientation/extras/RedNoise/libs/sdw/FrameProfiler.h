@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DrawingWindow.h"
+
+// Records how long each stage of a frame took and how much went through it, for every frame between
+// beginFrame and endFrame while it is enabled. The latest numbers can be drawn over the window with drawHUD
+// and the history of the last MAX_HISTORY frames saved with writeLog
+// It starts disabled, and then every call returns straight away without reading a clock, so the calls
+// can stay in the render code for good
+//
+//	profiler.beginFrame();
+//	{
+//		ScopedStageTimer timer(profiler, FrameProfiler::RASTERISE);
+//		...
+//	}
+//	profiler.count(FrameProfiler::TRIANGLES_DRAWN, drawn);
+//	profiler.endFrame();
+class FrameProfiler {
+public:
+	enum Stage { CULL, PROJECT, RASTERISE, TEXTURE, PRESENT, STAGE_COUNT };
+	enum Counter { TRIANGLES_IN, TRIANGLES_CULLED, TRIANGLES_DRAWN, PIXELS_TESTED, PIXELS_WRITTEN, PIXELS_COVERED, COUNTER_COUNT };
+	using Clock = std::chrono::steady_clock;
+	// About 18 minutes at 60 fps, older frames are dropped
+	static const size_t MAX_HISTORY = 65536;
+
+	struct Frame {
+		// Seconds from beginFrame to endFrame, the stages don't have to add up to it
+		double frameTime = 0;
+		double stageTimes[STAGE_COUNT] = {};
+		uint64_t counters[COUNTER_COUNT] = {};
+		// Pixels written per pixel covered, 1 means nothing was drawn over anything else
+		double overdraw() const;
+	};
+
+	bool isEnabled() const;
+	// Enabling starts a fresh history
+	void setEnabled(bool on);
+
+	// Times and counts only go into a frame, anything recorded outside beginFrame and endFrame is dropped
+	void beginFrame();
+	void endFrame();
+	void addTime(Stage stage, double seconds);
+	void count(Counter counter, uint64_t amount);
+
+	size_t frameCount() const;
+	// The last finished frame, or an empty one if there isn't one yet
+	const Frame &lastFrame() const;
+	// The frame time at the given percentile (0 to 100) of the last `recent` frames, or of all of them if recent is 0
+	double frameTimePercentile(double percentile, size_t recent = 0) const;
+
+	// Writes every recorded frame, as CSV if the filename ends in .csv and as JSON otherwise
+	// The JSON also has the p50, p95 and p99 frame times. Returns false if the file couldn't be written
+	bool writeLog(const std::string &filename) const;
+	// Draws the last frame's numbers in the top left corner of the window, over a darkened box
+	void drawHUD(DrawingWindow &window) const;
+
+	static const char *stageName(Stage stage);
+	static const char *counterName(Counter counter);
+
+private:
+	bool enabled = false;
+	bool inFrame = false;
+	Clock::time_point frameStart;
+	Frame current;
+	std::vector<Frame> frames;
+};
+
+// Adds the time until the end of its scope to a stage of the profiler's current frame
+class ScopedStageTimer {
+public:
+	ScopedStageTimer(FrameProfiler &profiler, FrameProfiler::Stage stage);
+	~ScopedStageTimer();
+	ScopedStageTimer(const ScopedStageTimer &) = delete;
+	ScopedStageTimer &operator=(const ScopedStageTimer &) = delete;
+
+private:
+	FrameProfiler &profiler;
+	FrameProfiler::Stage stage;
+	bool timing;
+	FrameProfiler::Clock::time_point start;
+};
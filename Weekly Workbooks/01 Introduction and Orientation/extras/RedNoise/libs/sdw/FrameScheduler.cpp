@@ -0,0 +1,46 @@
+#include <algorithm>
+#include "FrameScheduler.h"
+
+FrameScheduler::FrameScheduler(DrawingWindow &window, float targetFps) : window(window), nextFrame(Clock::now()) {
+	if (targetFps > 0) frameInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(1.0f / targetFps));
+	else frameInterval = Clock::duration::zero();
+}
+
+bool FrameScheduler::waitForInputEvents(std::vector<SDL_Event> &events) {
+	// Nothing to show, so there is nothing to do until the user does something
+	if (!window.isDirty() && !window.hasQueuedFrame()) return window.waitForInputEvents(events, -1);
+	Clock::duration remaining = nextFrame - Clock::now();
+	if (remaining <= Clock::duration::zero()) return window.pollForInputEvents(events);
+	// SDL waits in whole milliseconds. Rounding up wakes at most a millisecond late, where rounding down
+	// would come back early and poll in a loop for the rest of the frame
+	auto untilFrame = std::chrono::duration_cast<std::chrono::milliseconds>(remaining);
+	if (untilFrame < remaining) untilFrame += std::chrono::milliseconds(1);
+	return window.waitForInputEvents(events, int(untilFrame.count()));
+}
+
+bool FrameScheduler::presentIfDirty() {
+	if (!window.isDirty()) return presentQueued();
+	Clock::time_point now = Clock::now();
+	if (now < nextFrame) return false;
+	window.renderFrame();
+	presented++;
+	// Schedule from the frame that was due rather than from now, unless we have fallen a whole frame behind
+	nextFrame = std::max(nextFrame + frameInterval, now);
+	return true;
+}
+
+bool FrameScheduler::presentQueued() {
+	Clock::time_point now = Clock::now();
+	if (now < nextFrame || !window.presentQueuedFrame()) return false;
+	presented++;
+	nextFrame = std::max(nextFrame + frameInterval, now);
+	return true;
+}
+
+bool FrameScheduler::frameDue() const {
+	return Clock::now() >= nextFrame;
+}
+
+size_t FrameScheduler::framesPresented() const {
+	return presented;
+}
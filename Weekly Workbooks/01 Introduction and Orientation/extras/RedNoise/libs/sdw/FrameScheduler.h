@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include "DrawingWindow.h"
+
+// Drives a main loop without spinning: it sleeps in SDL until an input event arrives, and only presents
+// the window when something has been drawn into it since the last frame, at most targetFps times a second
+//
+//	FrameScheduler scheduler(window);
+//	while (true) {
+//		scheduler.waitForInputEvents(events);
+//		for (const SDL_Event &event : events) handleEvent(event, window);
+//		scheduler.presentIfDirty();
+//	}
+class FrameScheduler {
+public:
+	// A targetFps of 0 presents every dirty frame as soon as presentIfDirty is called
+	explicit FrameScheduler(DrawingWindow &window, float targetFps = 60);
+
+	// Blocks until there is input, or until the next frame is due if the window has changes
+	// or a queued frame waiting to be shown
+	// events is filled with everything that arrived since the last call, returns false if it is empty
+	bool waitForInputEvents(std::vector<SDL_Event> &events);
+	// Presents the window if it is dirty and the next frame is due, returns whether it did
+	// A window that isn't dirty still presents a frame that was queued from another thread
+	bool presentIfDirty();
+	// Presents the frame last handed over with DrawingWindow::queueFrame if the next frame is due, returns whether it did
+	// For loops that draw the next frame on other threads while this one goes to the screen
+	bool presentQueued();
+	// Whether presentIfDirty would present now if the window were dirty, for loops that draw every frame
+	bool frameDue() const;
+	size_t framesPresented() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	DrawingWindow &window;
+	Clock::duration frameInterval;
+	Clock::time_point nextFrame;
+	size_t presented = 0;
+};
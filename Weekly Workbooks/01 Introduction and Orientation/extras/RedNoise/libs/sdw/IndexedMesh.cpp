@@ -0,0 +1,77 @@
+#include "IndexedMesh.h"
+#include "Culling.h"
+
+size_t IndexedMesh::triangleCount() const {
+	return indices.size() / 3;
+}
+
+void IndexedMesh::reserve(size_t triangles) {
+	indices.reserve(3 * triangles);
+	materials.reserve(triangles);
+	normals.reserve(triangles);
+}
+
+void IndexedMesh::addTriangle(uint32_t v0, uint32_t v1, uint32_t v2, uint32_t material) {
+	indices.push_back(v0);
+	indices.push_back(v1);
+	indices.push_back(v2);
+	materials.push_back(material);
+	normals.push_back(faceNormal(vertices[v0], vertices[v1], vertices[v2]));
+}
+
+ModelTriangle IndexedMesh::triangle(size_t i) const {
+	return MeshView(*this).triangle(i);
+}
+
+MeshView::MeshView(const IndexedMesh &mesh)
+	: vertices(mesh.vertices), indices(mesh.indices.data()), normals(mesh.normals.data()), materials(mesh.materials.data()),
+	  textureCoordinates(mesh.textureCoordinates.empty() ? nullptr : mesh.textureCoordinates.data()),
+	  materialTable(&mesh.materialTable), triangles(mesh.triangleCount()) {}
+
+size_t MeshView::triangleCount() const {
+	return triangles;
+}
+
+const Colour &MeshView::colour(size_t i) const {
+	return (*materialTable)[materials[i]];
+}
+
+uint32_t MeshView::argb(size_t i) const {
+	return materialTable->argb(materials[i]);
+}
+
+ModelTriangle MeshView::triangle(size_t i) const {
+	ModelTriangle result(vertices[indices[3 * i]], vertices[indices[3 * i + 1]], vertices[indices[3 * i + 2]], materials[i]);
+	result.normal = normals[i];
+	if (textureCoordinates) {
+		for (int j = 0; j < 3; j++) result.texturePoints[j] = TexturePoint(textureCoordinates[3 * i + j].x, textureCoordinates[3 * i + j].y);
+	}
+	return result;
+}
+
+MeshView::Iterator MeshView::begin() const {
+	return Iterator(*this, 0);
+}
+
+MeshView::Iterator MeshView::end() const {
+	return Iterator(*this, triangles);
+}
+
+MeshView::Iterator::Iterator(const MeshView &mesh, size_t i) : mesh(&mesh), i(i) {}
+
+ModelTriangle MeshView::Iterator::operator*() const {
+	return mesh->triangle(i);
+}
+
+MeshView::Iterator &MeshView::Iterator::operator++() {
+	i++;
+	return *this;
+}
+
+bool MeshView::Iterator::operator==(const Iterator &other) const {
+	return mesh == other.mesh && i == other.i;
+}
+
+bool MeshView::Iterator::operator!=(const Iterator &other) const {
+	return !(*this == other);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Colour.h"
+#include "MaterialTable.h"
+#include "ModelTriangle.h"
+#include "VertexProjection.h"
+
+// A triangle mesh that stores every vertex once, with the triangles referring to their corners by index
+// Triangle i has corners vertices[indices[3i]], vertices[indices[3i + 1]] and vertices[indices[3i + 2]],
+// wound counter-clockwise when seen from the front, and its own face normal and number in the mesh's material table
+// Every attribute is a separate array (the positions even split into x, y and z), so each stage only pulls the ones
+// it reads through the cache: culling the positions and normals, projection the positions, indices and materials
+struct IndexedMesh {
+	VertexBuffer vertices;
+	std::vector<uint32_t> indices;
+	std::vector<uint32_t> materials;
+	std::vector<glm::vec3> normals;
+	// Three per triangle, lined up with indices, or none at all for a mesh without a texture
+	std::vector<glm::vec2> textureCoordinates;
+	MaterialTable materialTable;
+
+	size_t triangleCount() const;
+	// Makes room for that many triangles in total, so adding them doesn't keep reallocating
+	void reserve(size_t triangles);
+	// Appends a triangle and works out its normal from the winding
+	void addTriangle(uint32_t v0, uint32_t v1, uint32_t v2, uint32_t material);
+	// A standalone copy of triangle i, for code that works on ModelTriangles
+	ModelTriangle triangle(size_t i) const;
+};
+
+// A read-only indexed mesh over arrays that belong to something else, an IndexedMesh or a mapped SceneBundle,
+// laid out the same way as an IndexedMesh so the render stages can draw either without copying it
+struct MeshView {
+	VertexView vertices;
+	const uint32_t *indices{};
+	const glm::vec3 *normals{};
+	const uint32_t *materials{};
+	// Null for a mesh without a texture
+	const glm::vec2 *textureCoordinates{};
+	const MaterialTable *materialTable{};
+	size_t triangles{};
+
+	// Goes through the triangles as standalone ModelTriangles, so code written for a std::vector<ModelTriangle>
+	// can loop over a mesh with a range for. Each one is put together as it is reached
+	class Iterator {
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = ModelTriangle;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = ModelTriangle;
+
+		Iterator(const MeshView &mesh, size_t i);
+		ModelTriangle operator*() const;
+		Iterator &operator++();
+		bool operator==(const Iterator &other) const;
+		bool operator!=(const Iterator &other) const;
+
+	private:
+		const MeshView *mesh;
+		size_t i;
+	};
+
+	MeshView() = default;
+	MeshView(const IndexedMesh &mesh);
+	size_t triangleCount() const;
+	// The colour of triangle i, as it is in the material table and packed as 0xAARRGGBB
+	const Colour &colour(size_t i) const;
+	uint32_t argb(size_t i) const;
+	// A standalone copy of triangle i, for code that works on ModelTriangles
+	ModelTriangle triangle(size_t i) const;
+	Iterator begin() const;
+	Iterator end() const;
+};
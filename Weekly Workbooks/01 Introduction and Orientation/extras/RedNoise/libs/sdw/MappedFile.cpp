@@ -0,0 +1,60 @@
+#include <fstream>
+#include <iterator>
+#include "MappedFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAVE_MMAP
+#endif
+
+MappedFile::MappedFile(const std::string &filename) {
+#if defined(HAVE_MMAP)
+	int descriptor = ::open(filename.c_str(), O_RDONLY);
+	if (descriptor >= 0) {
+		struct stat status;
+		if (fstat(descriptor, &status) == 0) {
+			open = true;
+			length = size_t(status.st_size);
+			// mmap refuses a length of 0, and an empty file has nothing to map anyway
+			void *address = length > 0 ? mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+			if (address != MAP_FAILED) {
+				bytes = static_cast<const char *>(address);
+				mapped = true;
+			}
+		}
+		// The mapping keeps the file alive on its own
+		close(descriptor);
+		if (mapped || (open && length == 0)) return;
+		open = false;
+		length = 0;
+	}
+#endif
+	// No mmap, or it failed (some filesystems can't be mapped), so read the file instead
+	std::ifstream input(filename, std::ifstream::binary);
+	if (!input) return;
+	copy.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	open = true;
+	bytes = copy.data();
+	length = copy.size();
+}
+
+MappedFile::~MappedFile() {
+#if defined(HAVE_MMAP)
+	if (mapped) munmap(const_cast<char *>(bytes), length);
+#endif
+}
+
+bool MappedFile::isOpen() const {
+	return open;
+}
+
+const char *MappedFile::data() const {
+	return bytes;
+}
+
+size_t MappedFile::size() const {
+	return length;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// The whole of a file as read-only bytes, memory-mapped where the platform has mmap so nothing is copied
+// and pages are only read in as they are touched. Elsewhere the file is read into memory instead
+// The bytes are not null terminated, parse them as the range [data(), data() + size())
+class MappedFile {
+public:
+	explicit MappedFile(const std::string &filename);
+	~MappedFile();
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	// False if the file couldn't be opened, an empty file is open with a size of 0
+	bool isOpen() const;
+	const char *data() const;
+	size_t size() const;
+
+private:
+	bool open = false;
+	const char *bytes = nullptr;
+	size_t length = 0;
+	bool mapped = false;
+	std::vector<char> copy;
+};
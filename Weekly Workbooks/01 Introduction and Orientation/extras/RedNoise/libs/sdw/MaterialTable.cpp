@@ -0,0 +1,32 @@
+#include "MaterialTable.h"
+
+uint32_t MaterialTable::add(const Colour &colour) {
+	auto inserted = numbers.emplace(colour.name, uint32_t(colours.size()));
+	uint32_t material = inserted.first->second;
+	uint32_t value = (255u << 24) + (uint32_t(colour.red) << 16) + (uint32_t(colour.green) << 8) + uint32_t(colour.blue);
+	if (inserted.second) {
+		colours.push_back(colour);
+		packed.push_back(value);
+	} else {
+		colours[material] = colour;
+		packed[material] = value;
+	}
+	return material;
+}
+
+uint32_t MaterialTable::find(const std::string &name) const {
+	auto found = numbers.find(name);
+	return found == numbers.end() ? NOT_FOUND : found->second;
+}
+
+size_t MaterialTable::size() const {
+	return colours.size();
+}
+
+const Colour &MaterialTable::operator[](uint32_t material) const {
+	return colours[material];
+}
+
+uint32_t MaterialTable::argb(uint32_t material) const {
+	return packed[material];
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Colour.h"
+
+// The materials of a scene numbered densely from 0, so each triangle only has to store a small number
+// rather than a Colour with its name. Names are looked up once when a model is loaded, never while drawing
+class MaterialTable {
+public:
+	// What find returns for a name that isn't in the table
+	static const uint32_t NOT_FOUND = UINT32_MAX;
+
+	// Adds the colour under its name and returns its number
+	// A colour with a name that is already in the table replaces that one and keeps its number
+	uint32_t add(const Colour &colour);
+	uint32_t find(const std::string &name) const;
+	size_t size() const;
+	const Colour &operator[](uint32_t material) const;
+	// The colour as 0xAARRGGBB, fully opaque, ready to fill triangles with
+	uint32_t argb(uint32_t material) const;
+
+private:
+	std::vector<Colour> colours;
+	std::vector<uint32_t> packed;
+	std::unordered_map<std::string, uint32_t> numbers;
+};
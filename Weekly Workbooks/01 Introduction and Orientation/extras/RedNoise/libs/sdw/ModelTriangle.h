@@ -1,18 +1,19 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include <string>
+#include <cstdint>
 #include <array>
-#include "Colour.h"
 #include "TexturePoint.h"
 
+// A standalone triangle, plain data so copying one never allocates
+// Its colour is material in the MaterialTable of the mesh it came from
 struct ModelTriangle {
 	std::array<glm::vec3, 3> vertices{};
 	std::array<TexturePoint, 3> texturePoints{};
-	Colour colour{};
+	uint32_t material{};
 	glm::vec3 normal{};
 
 	ModelTriangle();
-	ModelTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2, Colour trigColour);
+	ModelTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2, uint32_t trigMaterial);
 	friend std::ostream &operator<<(std::ostream &os, const ModelTriangle &triangle);
 };
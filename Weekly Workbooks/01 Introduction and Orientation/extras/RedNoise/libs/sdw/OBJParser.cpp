@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include "MappedFile.h"
+#include "OBJParser.h"
+
+// Files are only cut up into chunks at least this big, so small ones are parsed on the calling thread
+static const size_t MIN_CHUNK_BYTES = size_t(1) << 22;
+static const uint32_t NO_MATERIAL = UINT32_MAX;
+
+size_t OBJData::triangleCount() const {
+	return materials.size();
+}
+
+static bool isSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static bool isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+static const char *skipSpaces(const char *p, const char *end) {
+	while (p < end && isSpace(*p)) p++;
+	return p;
+}
+
+static const char *skipToken(const char *p, const char *end) {
+	while (p < end && !isSpace(*p)) p++;
+	return p;
+}
+
+// Whether the line at p starts with the keyword followed by whitespace or the end of the line
+static bool startsWithKeyword(const char *p, const char *end, const char *keyword, size_t length) {
+	return size_t(end - p) >= length && std::memcmp(p, keyword, length) == 0 && (p + length == end || isSpace(p[length]));
+}
+
+// Calls handle(lineBegin, lineEnd) for every line of [begin, end), lineEnd is the '\n' or end
+template <typename Handler>
+static void forEachLine(const char *begin, const char *end, Handler handle) {
+	while (begin < end) {
+		const char *newline = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+		const char *lineEnd = newline ? newline : end;
+		handle(begin, lineEnd);
+		begin = newline ? newline + 1 : end;
+	}
+}
+
+// Hands the token to strtof, for the numbers the fast path can't do exactly
+static float parseFloatSlowly(const char *p, const char *tokenEnd) {
+	char buffer[128];
+	size_t length = std::min(size_t(tokenEnd - p), sizeof(buffer) - 1);
+	std::memcpy(buffer, p, length);
+	buffer[length] = '\0';
+	return std::strtof(buffer, nullptr);
+}
+
+// Reads the number at p as a float, giving exactly what strtof (and so std::stof) would, and moves p past it
+// A decimal with up to 15 significant digits and a power of ten up to 22 is exact as double(digits) times or divided by
+// an exact power of ten, which is one correctly rounded operation. Rounding that double to float again only
+// differs from rounding the decimal straight to float when the double lands exactly halfway between two floats,
+// so those, and everything else that isn't a plain decimal, go to strtof
+static float parseFloat(const char *&cursor, const char *lineEnd) {
+	static const double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	const char *start = cursor;
+	const char *p = cursor;
+	bool negative = false;
+	if (p < lineEnd && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+	// Leading zeros aren't significant, digits stays 0 until the first other digit
+	uint64_t digits = 0;
+	int significant = 0;
+	const char *integerStart = p;
+	for (; p < lineEnd && isDigit(*p); p++) {
+		digits = digits * 10 + uint64_t(*p - '0');
+		significant += digits != 0;
+	}
+	bool anyDigits = p != integerStart;
+	int exponent = 0;
+	if (p < lineEnd && *p == '.') {
+		const char *fractionStart = ++p;
+		for (; p < lineEnd && isDigit(*p); p++) {
+			digits = digits * 10 + uint64_t(*p - '0');
+			significant += digits != 0;
+		}
+		exponent = -int(p - fractionStart);
+		anyDigits = anyDigits || p != fractionStart;
+	}
+	bool exact = significant <= 15;
+	if (p < lineEnd && (*p == 'e' || *p == 'E')) {
+		p++;
+		bool negativeExponent = false;
+		if (p < lineEnd && (*p == '-' || *p == '+')) negativeExponent = (*p++ == '-');
+		const char *powerStart = p;
+		int power = 0;
+		for (; p < lineEnd && isDigit(*p); p++) power = std::min(power * 10 + (*p - '0'), 10000);
+		exact = exact && p != powerStart;
+		exponent += negativeExponent ? -power : power;
+	}
+	// The number has to take up the whole token, anything else (such as 0x1p3) isn't a plain decimal
+	exact = exact && anyDigits && (p == lineEnd || isSpace(*p)) && exponent >= -22 && exponent <= 22;
+	const char *tokenEnd = skipToken(p, lineEnd);
+	cursor = tokenEnd;
+	if (!exact) return parseFloatSlowly(start, tokenEnd);
+
+	double value = exponent < 0 ? double(digits) / POWERS_OF_TEN[-exponent] : double(digits) * POWERS_OF_TEN[exponent];
+	// Subnormal and out of range floats round differently, leave them to strtof too
+	if (value != 0.0 && (value < FLT_MIN || value > FLT_MAX)) return parseFloatSlowly(start, tokenEnd);
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	// The 29 double mantissa bits a float doesn't have are exactly one half of a float step
+	if ((bits & ((uint64_t(1) << 29) - 1)) == (uint64_t(1) << 28)) return parseFloatSlowly(start, tokenEnd);
+	return negative ? -float(value) : float(value);
+}
+
+// Reads a signed index at p and moves p past it, false if there are no digits there
+static bool parseIndex(const char *&p, const char *lineEnd, int64_t &index) {
+	bool negative = false;
+	if (p < lineEnd && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+	bool anyDigits = p < lineEnd && isDigit(*p);
+	int64_t value = 0;
+	for (; p < lineEnd && isDigit(*p); p++) value = std::min(value * 10 + (*p - '0'), int64_t(1) << 40);
+	index = negative ? -value : value;
+	return anyDigits;
+}
+
+// Reads a face corner such as "12", "12/5", "12/" or "-3//1" and moves p past it
+// texture is 0 if the corner has no texture coordinate, the normal index is skipped
+static bool parseCorner(const char *&p, const char *lineEnd, int64_t &vertex, int64_t &texture) {
+	bool valid = parseIndex(p, lineEnd, vertex);
+	texture = 0;
+	if (valid && p < lineEnd && *p == '/') {
+		p++;
+		if (p < lineEnd && *p != '/' && !isSpace(*p)) valid = parseIndex(p, lineEnd, texture);
+	}
+	p = skipToken(p, lineEnd);
+	return valid;
+}
+
+// Turns a one-based (or negative, counting back from the latest) index into a zero-based one, -1 if it is out of range
+static int64_t resolveIndex(int64_t index, size_t seen, size_t total) {
+	int64_t resolved = index > 0 ? index - 1 : int64_t(seen) + index;
+	return (index == 0 || resolved < 0 || resolved >= int64_t(total)) ? -1 : resolved;
+}
+
+// What one chunk of the file held, with its indices already pointing into the whole file's vertices
+// and its materials numbered in the order the chunk named them
+struct OBJChunk {
+	const char *begin;
+	const char *end;
+	// How many vertices and texture coordinates come before the chunk
+	size_t firstVertex = 0;
+	size_t firstTextureCoordinate = 0;
+	size_t vertexCount = 0;
+	size_t textureCoordinateCount = 0;
+	size_t faceCount = 0;
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t> indices;
+	std::vector<glm::vec2> textureCoordinates;
+	// Empty until the chunk's first corner with a texture coordinate, then one for every corner
+	std::vector<uint32_t> textureIndices;
+	bool anyTextureIndex = false;
+	// NO_MATERIAL for the triangles before the chunk's first usemtl, they carry on from the chunk before
+	std::vector<uint32_t> materials;
+	std::vector<std::string> materialNames;
+	uint32_t lastMaterial = NO_MATERIAL;
+	bool badIndex = false;
+	bool badIndexIsTexture = false;
+	int64_t badIndexValue = 0;
+};
+
+// Counts the v, vt and f lines, the face count is only used to reserve space
+static void countLines(OBJChunk &chunk) {
+	forEachLine(chunk.begin, chunk.end, [&](const char *p, const char *lineEnd) {
+		p = skipSpaces(p, lineEnd);
+		if (startsWithKeyword(p, lineEnd, "v", 1)) chunk.vertexCount++;
+		else if (startsWithKeyword(p, lineEnd, "f", 1)) chunk.faceCount++;
+		else if (startsWithKeyword(p, lineEnd, "vt", 2)) chunk.textureCoordinateCount++;
+	});
+}
+
+static void parseChunk(OBJChunk &chunk, size_t totalVertices, size_t totalTextureCoordinates) {
+	size_t vertexCount = chunk.firstVertex;
+	size_t textureCoordinateCount = chunk.firstTextureCoordinate;
+	uint32_t material = NO_MATERIAL;
+	bool textured = false;
+	// Fresh memory is slow to touch for the first time, so grow each array once rather than by doubling
+	chunk.positions.reserve(chunk.vertexCount);
+	chunk.textureCoordinates.reserve(chunk.textureCoordinateCount);
+	chunk.indices.reserve(3 * chunk.faceCount);
+	chunk.materials.reserve(chunk.faceCount);
+	forEachLine(chunk.begin, chunk.end, [&](const char *p, const char *lineEnd) {
+		p = skipSpaces(p, lineEnd);
+		if (startsWithKeyword(p, lineEnd, "v", 1)) {
+			// Missing coordinates are left at 0
+			float coordinates[3] = {};
+			p++;
+			for (float &coordinate : coordinates) {
+				p = skipSpaces(p, lineEnd);
+				if (p != lineEnd) coordinate = parseFloat(p, lineEnd);
+			}
+			chunk.positions.push_back(glm::vec3(coordinates[0], coordinates[1], coordinates[2]));
+			vertexCount++;
+		} else if (startsWithKeyword(p, lineEnd, "f", 1)) {
+			uint32_t first = 0;
+			uint32_t previous = 0;
+			uint32_t firstTexture = NO_TEXTURE_COORDINATE;
+			uint32_t previousTexture = NO_TEXTURE_COORDINATE;
+			int corners = 0;
+			for (p = skipSpaces(p + 1, lineEnd); p < lineEnd; p = skipSpaces(p, lineEnd)) {
+				int64_t index = 0;
+				int64_t textureIndex = 0;
+				// Positive indices count from 1 at the start of the file, negative ones back from the latest vertex
+				int64_t resolved = parseCorner(p, lineEnd, index, textureIndex) ? resolveIndex(index, vertexCount, totalVertices) : -1;
+				if (resolved < 0) {
+					if (!chunk.badIndex) chunk.badIndexValue = index;
+					chunk.badIndex = true;
+					return;
+				}
+				uint32_t corner = uint32_t(resolved);
+				uint32_t texture = NO_TEXTURE_COORDINATE;
+				if (textureIndex != 0) {
+					int64_t resolvedTexture = resolveIndex(textureIndex, textureCoordinateCount, totalTextureCoordinates);
+					if (resolvedTexture < 0) {
+						if (!chunk.badIndex) {
+							chunk.badIndexIsTexture = true;
+							chunk.badIndexValue = textureIndex;
+						}
+						chunk.badIndex = true;
+						return;
+					}
+					texture = uint32_t(resolvedTexture);
+					if (!textured) chunk.textureIndices.reserve(3 * chunk.faceCount);
+					textured = true;
+				}
+				if (corners == 0) {
+					first = corner;
+					firstTexture = texture;
+				}
+				if (corners >= 2) {
+					chunk.indices.push_back(first);
+					chunk.indices.push_back(previous);
+					chunk.indices.push_back(corner);
+					if (textured) {
+						// The triangles before the first texture coordinate didn't have one
+						chunk.textureIndices.resize(chunk.indices.size() - 3, NO_TEXTURE_COORDINATE);
+						chunk.textureIndices.push_back(firstTexture);
+						chunk.textureIndices.push_back(previousTexture);
+						chunk.textureIndices.push_back(texture);
+					}
+					chunk.materials.push_back(material);
+				}
+				previous = corner;
+				previousTexture = texture;
+				corners++;
+			}
+		} else if (startsWithKeyword(p, lineEnd, "vt", 2)) {
+			float coordinates[2] = {};
+			p += 2;
+			for (float &coordinate : coordinates) {
+				p = skipSpaces(p, lineEnd);
+				if (p != lineEnd) coordinate = parseFloat(p, lineEnd);
+			}
+			chunk.textureCoordinates.push_back(glm::vec2(coordinates[0], coordinates[1]));
+			textureCoordinateCount++;
+		} else if (startsWithKeyword(p, lineEnd, "usemtl", 6)) {
+			p = skipSpaces(p + 6, lineEnd);
+			std::string name(p, skipToken(p, lineEnd));
+			auto found = std::find(chunk.materialNames.begin(), chunk.materialNames.end(), name);
+			material = uint32_t(found - chunk.materialNames.begin());
+			if (found == chunk.materialNames.end()) chunk.materialNames.push_back(name);
+			chunk.lastMaterial = material;
+		}
+	});
+	chunk.anyTextureIndex = textured;
+}
+
+static void forEachChunk(ThreadPool *pool, std::vector<OBJChunk> &chunks, const std::function<void(OBJChunk &)> &task) {
+	if (pool != nullptr && chunks.size() > 1) pool->parallelFor(chunks.size(), [&](size_t i) { task(chunks[i]); });
+	else for (OBJChunk &chunk : chunks) task(chunk);
+}
+
+bool parseOBJ(const char *begin, const char *end, OBJData &result, ThreadPool *pool) {
+	result = OBJData();
+	size_t bytes = size_t(end - begin);
+	size_t chunkCount = 1;
+	if (pool != nullptr) chunkCount = std::max(size_t(1), std::min(pool->size() * 4, bytes / MIN_CHUNK_BYTES));
+
+	// Chunks start just after a line break, so no line is split between two of them
+	std::vector<OBJChunk> chunks(chunkCount);
+	const char *chunkStart = begin;
+	for (size_t i = 0; i < chunkCount; i++) {
+		const char *chunkEnd = end;
+		if (i + 1 < chunkCount) {
+			const char *target = std::max(chunkStart, begin + bytes / chunkCount * (i + 1));
+			const char *newline = static_cast<const char *>(std::memchr(target, '\n', end - target));
+			chunkEnd = newline ? newline + 1 : end;
+		}
+		chunks[i].begin = chunkStart;
+		chunks[i].end = chunkEnd;
+		chunkStart = chunkEnd;
+	}
+
+	// Negative face indices count back from the vertices before them, so every chunk
+	// has to know how many vertices came earlier before any faces can be read
+	forEachChunk(pool, chunks, countLines);
+	size_t totalVertices = 0;
+	size_t totalTextureCoordinates = 0;
+	bool textured = false;
+	for (OBJChunk &chunk : chunks) {
+		chunk.firstVertex = totalVertices;
+		chunk.firstTextureCoordinate = totalTextureCoordinates;
+		totalVertices += chunk.vertexCount;
+		totalTextureCoordinates += chunk.textureCoordinateCount;
+	}
+	forEachChunk(pool, chunks, [&](OBJChunk &chunk) { parseChunk(chunk, totalVertices, totalTextureCoordinates); });
+
+	for (const OBJChunk &chunk : chunks) {
+		textured = textured || chunk.anyTextureIndex;
+		if (!chunk.badIndex) continue;
+		if (chunk.badIndexIsTexture)
+			result.error = "a face refers to texture coordinate " + std::to_string(chunk.badIndexValue) + " but there are " +
+			               std::to_string(totalTextureCoordinates) + " texture coordinates";
+		else
+			result.error = "a face refers to vertex " + std::to_string(chunk.badIndexValue) + " but there are " +
+			               std::to_string(totalVertices) + " vertices";
+		return false;
+	}
+
+	// Number the materials across the whole file, and work out which one each chunk starts with
+	std::unordered_map<std::string, uint32_t> materialIds;
+	auto materialId = [&](const std::string &name) {
+		auto inserted = materialIds.emplace(name, uint32_t(result.materialNames.size()));
+		if (inserted.second) result.materialNames.push_back(name);
+		return inserted.first->second;
+	};
+	std::vector<std::vector<uint32_t>> materialMaps(chunks.size());
+	std::vector<size_t> firstTriangle(chunks.size());
+	uint32_t material = NO_MATERIAL;
+	size_t triangles = 0;
+	for (size_t i = 0; i < chunks.size(); i++) {
+		const OBJChunk &chunk = chunks[i];
+		firstTriangle[i] = triangles;
+		triangles += chunk.materials.size();
+		if (!chunk.materials.empty() && chunk.materials[0] == NO_MATERIAL && material == NO_MATERIAL) material = materialId("");
+		// The chunk's own numbers, with NO_MATERIAL at the end for the triangles carried on from before
+		for (const std::string &name : chunk.materialNames) materialMaps[i].push_back(materialId(name));
+		materialMaps[i].push_back(material);
+		if (chunk.lastMaterial != NO_MATERIAL) material = materialMaps[i][chunk.lastMaterial];
+	}
+
+	auto globalMaterial = [&](size_t chunk, uint32_t local) {
+		const std::vector<uint32_t> &map = materialMaps[chunk];
+		return map[local == NO_MATERIAL ? map.size() - 1 : local];
+	};
+	if (chunks.size() == 1) {
+		// Nothing to join, so the chunk's arrays become the result instead of being copied
+		result.positions.swap(chunks[0].positions);
+		result.indices.swap(chunks[0].indices);
+		result.textureCoordinates.swap(chunks[0].textureCoordinates);
+		if (textured) result.textureIndices.swap(chunks[0].textureIndices);
+		result.materials.swap(chunks[0].materials);
+		for (uint32_t &material : result.materials) material = globalMaterial(0, material);
+		return true;
+	}
+	result.positions.resize(totalVertices);
+	result.indices.resize(3 * triangles);
+	result.textureCoordinates.resize(totalTextureCoordinates);
+	result.textureIndices.resize(textured ? 3 * triangles : 0, NO_TEXTURE_COORDINATE);
+	result.materials.resize(triangles);
+	forEachChunk(pool, chunks, [&](OBJChunk &chunk) {
+		size_t i = size_t(&chunk - chunks.data());
+		std::copy(chunk.positions.begin(), chunk.positions.end(), result.positions.begin() + chunk.firstVertex);
+		std::copy(chunk.indices.begin(), chunk.indices.end(), result.indices.begin() + 3 * firstTriangle[i]);
+		std::copy(chunk.textureCoordinates.begin(), chunk.textureCoordinates.end(),
+		          result.textureCoordinates.begin() + chunk.firstTextureCoordinate);
+		if (textured) std::copy(chunk.textureIndices.begin(), chunk.textureIndices.end(), result.textureIndices.begin() + 3 * firstTriangle[i]);
+		for (size_t t = 0; t < chunk.materials.size(); t++) result.materials[firstTriangle[i] + t] = globalMaterial(i, chunk.materials[t]);
+	});
+	return true;
+}
+
+bool parseOBJFile(const std::string &filename, OBJData &result, ThreadPool *pool) {
+	MappedFile file(filename);
+	if (!file.isOpen()) {
+		result = OBJData();
+		result.error = "can't open " + filename;
+		return false;
+	}
+	return parseOBJ(file.data(), file.data() + file.size(), result, pool);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ThreadPool.h"
+
+// What OBJData::textureIndices holds for a face corner that didn't give a texture coordinate
+const uint32_t NO_TEXTURE_COORDINATE = UINT32_MAX;
+
+// The geometry of an .obj file as flat arrays, ready to build a mesh from
+// Polygons with more than three corners are split into fans of triangles around their first corner
+struct OBJData {
+	// One entry per "v" line, in file order
+	std::vector<glm::vec3> positions;
+	// Three zero-based indices into positions per triangle, in the order the corners were listed
+	std::vector<uint32_t> indices;
+	// One entry per "vt" line, in file order
+	std::vector<glm::vec2> textureCoordinates;
+	// Three indices into textureCoordinates per triangle, lined up with indices, empty if no face gave any
+	std::vector<uint32_t> textureIndices;
+	// Per triangle, which of materialNames the last "usemtl" before it named, "" if there wasn't one
+	std::vector<uint32_t> materials;
+	std::vector<std::string> materialNames;
+	// What was wrong with the file when parseOBJ returns false
+	std::string error;
+
+	size_t triangleCount() const;
+};
+
+// Parses the .obj text in [begin, end) without copying it, normally straight out of a MappedFile
+// With a pool, files of more than a few megabytes are cut into chunks at line breaks that are parsed in parallel
+// and then joined in order, giving exactly what parsing them in one go would
+// Numbers are read to the same floats as std::stof. Only v, vt, f and usemtl lines are used, everything else is skipped
+// Returns false, with result.error set, if a face refers to a vertex or texture coordinate that doesn't exist
+bool parseOBJ(const char *begin, const char *end, OBJData &result, ThreadPool *pool = nullptr);
+// Maps the file and parses it, returns false if it can't be opened too
+bool parseOBJFile(const std::string &filename, OBJData &result, ThreadPool *pool = nullptr);
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include "BitmapFont.h"
+#include "OverdrawMap.h"
+
+static const uint32_t HEAT_COLOURS[] = {
+	0xFF000000, 0xFF000080, 0xFF0000FF, 0xFF00FFFF, 0xFF00FF00, 0xFFFFFF00, 0xFFFF8000, 0xFFFF0000, 0xFFFFFFFF
+};
+static const uint32_t HEAT_LEVELS = sizeof(HEAT_COLOURS) / sizeof(HEAT_COLOURS[0]);
+
+OverdrawMap::OverdrawMap(size_t w, size_t h) : w(w), h(h), tests(w * h), writes(w * h) {}
+
+void OverdrawMap::resize(size_t newWidth, size_t newHeight) {
+	w = newWidth;
+	h = newHeight;
+	tests.assign(w * h, 0);
+	writes.assign(w * h, 0);
+}
+
+void OverdrawMap::clear() {
+	std::fill(tests.begin(), tests.end(), 0);
+	std::fill(writes.begin(), writes.end(), 0);
+}
+
+void OverdrawMap::attach(RasterStats &stats) {
+	stats.testCounts = tests.data();
+	stats.writeCounts = writes.data();
+	stats.countStride = w;
+}
+
+size_t OverdrawMap::width() const {
+	return w;
+}
+
+size_t OverdrawMap::height() const {
+	return h;
+}
+
+const std::vector<uint32_t> &OverdrawMap::counts(Kind kind) const {
+	return kind == DEPTH_TESTS ? tests : writes;
+}
+
+uint32_t OverdrawMap::count(Kind kind, int x, int y) const {
+	return counts(kind)[y * w + x];
+}
+
+uint64_t OverdrawMap::total(Kind kind) const {
+	const std::vector<uint32_t> &values = counts(kind);
+	return std::accumulate(values.begin(), values.end(), uint64_t(0));
+}
+
+uint32_t OverdrawMap::maximum(Kind kind) const {
+	const std::vector<uint32_t> &values = counts(kind);
+	return values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+}
+
+void OverdrawMap::drawHeatMap(Kind kind, uint32_t *pixels, size_t stride) const {
+	const std::vector<uint32_t> &values = counts(kind);
+	for (size_t y = 0; y < h; y++) {
+		const uint32_t *row = values.data() + y * w;
+		uint32_t *destination = pixels + y * stride;
+		for (size_t x = 0; x < w; x++) destination[x] = HEAT_COLOURS[std::min(row[x], HEAT_LEVELS - 1)];
+	}
+}
+
+void OverdrawMap::drawLegend(Kind kind, DrawingWindow &window) const {
+	int scale = window.width >= 640 ? 2 : 1;
+	int swatch = (GLYPH_WIDTH + 1) * 3 * scale;
+	int top = int(window.height) - (GLYPH_HEIGHT + 4) * scale;
+	int x = 2 * scale;
+	// On a black strip, so the caption can be read whatever is under it
+	for (int y = top - 2 * scale; y < int(window.height); y++) window.fillSpan(0, y, int(window.width), 0xFF000000);
+	// Swatches for 1 up to the last level, each labelled with its count
+	for (uint32_t level = 1; level < HEAT_LEVELS; level++) {
+		for (int y = top - scale; y < int(window.height); y++) window.fillSpan(x, y, swatch, HEAT_COLOURS[level]);
+		std::string label = std::to_string(level) + (level == HEAT_LEVELS - 1 ? "+" : "");
+		drawText(window, x + scale, top + scale, label, (level >= 3 && level <= 6) ? 0xFF000000 : 0xFFFFFFFF, scale);
+		x += swatch;
+	}
+	std::string caption = std::string(kind == DEPTH_TESTS ? "DEPTH TESTS" : "COLOUR WRITES") +
+	                      " TOTAL " + std::to_string(total(kind)) + " MAX " + std::to_string(maximum(kind));
+	drawText(window, x + 2 * scale, top + scale, caption, 0xFFFFFFFF, scale);
+}
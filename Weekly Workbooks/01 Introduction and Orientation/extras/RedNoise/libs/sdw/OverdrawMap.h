@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "DrawingWindow.h"
+#include "Rasteriser.h"
+
+// How many times each pixel of a frame was depth tested and written, for finding the views that shade
+// the same pixels over and over. Attach it to the RasterStats a frame is filled with, then draw it as a heat map
+// Skipped triangles and depth pyramid cells never reach the fill, so they don't count as tests
+class OverdrawMap {
+public:
+	enum Kind { DEPTH_TESTS, COLOUR_WRITES };
+
+	OverdrawMap(size_t w = 0, size_t h = 0);
+	// Changes the size and clears the counts
+	void resize(size_t w, size_t h);
+	void clear();
+	// Points stats at the per-pixel counts, the totals in stats are left alone
+	void attach(RasterStats &stats);
+
+	size_t width() const;
+	size_t height() const;
+	uint32_t count(Kind kind, int x, int y) const;
+	uint64_t total(Kind kind) const;
+	uint32_t maximum(Kind kind) const;
+
+	// Colours every pixel by its count: black for 0, then dark blue, blue, cyan, green, yellow, orange and red
+	// for 1 to 7 and white for 8 or more. pixels is row-major with the given stride
+	void drawHeatMap(Kind kind, uint32_t *pixels, size_t stride) const;
+	// A key for the heat map colours along the bottom of the window, with the frame's total and maximum
+	void drawLegend(Kind kind, DrawingWindow &window) const;
+
+private:
+	size_t w;
+	size_t h;
+	std::vector<uint32_t> tests;
+	std::vector<uint32_t> writes;
+
+	const std::vector<uint32_t> &counts(Kind kind) const;
+};
@@ -0,0 +1,570 @@
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <glm/gtc/type_precision.hpp>
+#include "Rasteriser.h"
+#include "DepthPyramid.h"
+#include "TextureMap.h"
+
+// Pick the widest kernel the compiler is targeting, define SDW_SCALAR_RASTER to force the plain loop
+#if !defined(SDW_SCALAR_RASTER) && defined(__AVX2__)
+#include <immintrin.h>
+#define RASTER_AVX2
+static const int LANES = 8;
+#elif !defined(SDW_SCALAR_RASTER) && defined(__SSE2__)
+#include <emmintrin.h>
+#define RASTER_SSE2
+static const int LANES = 4;
+#else
+static const int LANES = 1;
+#endif
+
+// Pixels are processed in groups of one depth pyramid cell row
+static const int GROUP = DepthPyramid::CELL_SIZE;
+
+PixelRect::PixelRect() = default;
+PixelRect::PixelRect(int left, int top, int right, int bottom) :
+		minX(left), minY(top), maxX(right), maxY(bottom) {}
+
+bool PixelRect::isEmpty() const {
+	return (minX > maxX) || (minY > maxY);
+}
+
+PixelRect PixelRect::intersect(const PixelRect &other) const {
+	return PixelRect(std::max(minX, other.minX), std::max(minY, other.minY),
+	                 std::min(maxX, other.maxX), std::min(maxY, other.maxY));
+}
+
+int32_t toFixedPoint(float coordinate) {
+	const float limit = float(1 << 18);
+	return int32_t(std::lrint(std::min(std::max(coordinate, -limit), limit) * SUBPIXEL_SCALE));
+}
+
+// The first and last whole pixel at or after / at or before a fixed point coordinate
+static int ceilToPixel(int32_t fixed) {
+	return -((-fixed) >> SUBPIXEL_BITS);
+}
+
+static int floorToPixel(int32_t fixed) {
+	return fixed >> SUBPIXEL_BITS;
+}
+
+PixelRect triangleBounds(const CanvasTriangle &triangle) {
+	int32_t x0 = toFixedPoint(triangle.vertices[0].x);
+	int32_t x1 = toFixedPoint(triangle.vertices[1].x);
+	int32_t x2 = toFixedPoint(triangle.vertices[2].x);
+	int32_t y0 = toFixedPoint(triangle.vertices[0].y);
+	int32_t y1 = toFixedPoint(triangle.vertices[1].y);
+	int32_t y2 = toFixedPoint(triangle.vertices[2].y);
+	return PixelRect(ceilToPixel(std::min(std::min(x0, x1), x2)), ceilToPixel(std::min(std::min(y0, y1), y2)),
+	                 floorToPixel(std::max(std::max(x0, x1), x2)), floorToPixel(std::max(std::max(y0, y1), y2)));
+}
+
+// Twice the signed area of the triangle (a, b, p), exact for fixed point points
+static int64_t edgeFunction(const glm::i64vec2 &a, const glm::i64vec2 &b, const glm::i64vec2 &p) {
+	return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+}
+
+// With the vertices ordered so the area is positive, screen y pointing down, an edge going up the screen
+// is a left edge and a horizontal edge going right is a top edge
+static bool isTopLeft(const glm::i64vec2 &a, const glm::i64vec2 &b) {
+	return (b.y < a.y) || (b.y == a.y && b.x > a.x);
+}
+
+TriangleSetup::TriangleSetup(const CanvasTriangle &triangle) {
+	glm::i64vec2 p[3];
+	for (int i = 0; i < 3; i++) {
+		p[i] = glm::i64vec2(toFixedPoint(triangle.vertices[i].x), toFixedPoint(triangle.vertices[i].y));
+	}
+	int64_t area = edgeFunction(p[0], p[1], p[2]);
+	isDegenerate = (area == 0);
+	if (isDegenerate) return;
+
+	// Coverage doesn't depend on winding, so walk the edges in whichever order makes the inside positive
+	int order[3] = {0, 1, 2};
+	if (area < 0) std::swap(order[1], order[2]);
+	for (int i = 0; i < 3; i++) {
+		const glm::i64vec2 &a = p[order[(i + 1) % 3]];
+		const glm::i64vec2 &b = p[order[(i + 2) % 3]];
+		// Pixel (x, y) samples the fixed point position (x, y) * SUBPIXEL_SCALE
+		// Off the top-left rule the bias of -1 turns "> 0" into ">= 0", so every edge uses the same test
+		edge[i] = edgeFunction(a, b, glm::i64vec2(0, 0)) - (isTopLeft(a, b) ? 0 : 1);
+		edgeStepX[i] = int32_t((a.y - b.y) * SUBPIXEL_SCALE);
+		edgeStepY[i] = int32_t((b.x - a.x) * SUBPIXEL_SCALE);
+	}
+
+	// The depth plane goes through the snapped vertices, so it agrees with the coverage
+	glm::vec2 q0(p[0]), q1(p[1]), q2(p[2]);
+	q0 /= float(SUBPIXEL_SCALE);
+	q1 /= float(SUBPIXEL_SCALE);
+	q2 /= float(SUBPIXEL_SCALE);
+	// How much each barycentric weight changes per pixel, with the area converted back to square pixels
+	float inverseArea = float(SUBPIXEL_SCALE * SUBPIXEL_SCALE) / float(area);
+	weightStepX = glm::vec3(q1.y - q2.y, q2.y - q0.y, q0.y - q1.y) * inverseArea;
+	weightStepY = glm::vec3(q2.x - q1.x, q0.x - q2.x, q1.x - q0.x) * inverseArea;
+	glm::vec3 vertexDepths(triangle.vertices[0].depth, triangle.vertices[1].depth, triangle.vertices[2].depth);
+	origin = q0;
+	depth = triangle.vertices[0].depth;
+	depthStepX = glm::dot(weightStepX, vertexDepths);
+	depthStepY = glm::dot(weightStepY, vertexDepths);
+}
+
+int64_t TriangleSetup::edgeAt(int i, int x, int y) const {
+	return edge[i] + int64_t(edgeStepX[i]) * x + int64_t(edgeStepY[i]) * y;
+}
+
+bool TriangleSetup::covers(int x, int y) const {
+	return edgeAt(0, x, y) >= 0 && edgeAt(1, x, y) >= 0 && edgeAt(2, x, y) >= 0;
+}
+
+float TriangleSetup::depthAt(int x, int y) const {
+	return depth + depthStepX * (x - origin.x) + depthStepY * (y - origin.y);
+}
+
+// Rounds a depth up by more than the interpolation error, so skipping on it never hides a pixel that would have passed
+static float conservativeDepth(float depth) {
+	return depth + std::abs(depth) * 1e-4f + 1e-7f;
+}
+
+float nearestDepth(const CanvasTriangle &triangle) {
+	const CanvasPoint &v0 = triangle.vertices[0];
+	const CanvasPoint &v1 = triangle.vertices[1];
+	const CanvasPoint &v2 = triangle.vertices[2];
+	return conservativeDepth(std::max(std::max(v0.depth, v1.depth), v2.depth));
+}
+
+void RasterStats::add(const RasterStats &other) {
+	pixelsTested += other.pixelsTested;
+	pixelsWritten += other.pixelsWritten;
+}
+
+RasterBuffer::RasterBuffer() = default;
+RasterBuffer::RasterBuffer(uint32_t *colourData, float *depthData, size_t rowStride, int x, int y, DepthPyramid *pyramid) :
+		colour(colourData), depth(depthData), stride(rowStride), originX(x), originY(y), depthPyramid(pyramid) {}
+
+const char *rasterKernelName() {
+#if defined(RASTER_AVX2)
+	return "avx2";
+#elif defined(RASTER_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+int rasterKernelWidth() {
+	return LANES;
+}
+
+// Per-lane offsets from the edge functions and depth at the start of a group
+struct GroupOffsets {
+	int32_t edge0[GROUP];
+	int32_t edge1[GROUP];
+	int32_t edge2[GROUP];
+	float depth[GROUP];
+};
+
+// The edge functions at the start of a group, clamped to 32 bits
+// A group only spans 8 pixels and a step is below 2^27, so clamping to +-2^30 keeps the sign of every lane
+struct GroupEdges {
+	int32_t edge0;
+	int32_t edge1;
+	int32_t edge2;
+};
+
+static const int64_t EDGE_LIMIT = int64_t(1) << 30;
+
+static int32_t clampEdge(int64_t value) {
+	return int32_t(std::min(std::max(value, -EDGE_LIMIT), EDGE_LIMIT));
+}
+
+// Edge functions are linear, so they are largest at the corners of the groups that cover the area
+// Usually they all fit easily and the groups can skip clamping
+static bool edgesFitGroups(const TriangleSetup &setup, const PixelRect &area) {
+	int left = area.minX - area.minX % GROUP;
+	int right = area.maxX - area.maxX % GROUP + GROUP - 1;
+	for (int e = 0; e < 3; e++) {
+		for (int64_t value : {setup.edgeAt(e, left, area.minY), setup.edgeAt(e, right, area.minY),
+		                      setup.edgeAt(e, left, area.maxY), setup.edgeAt(e, right, area.maxY)}) {
+			if (value <= -EDGE_LIMIT || value >= EDGE_LIMIT) return false;
+		}
+	}
+	return true;
+}
+
+// Which pixels of a group were covered and which of those passed the depth test, bit k for pixel k
+struct GroupCoverage {
+	uint32_t tested;
+	uint32_t written;
+};
+
+static int countLanes(uint32_t mask) {
+	return int(std::bitset<32>(mask).count());
+}
+
+// Fills pixels [first, last] of one group (0 <= first <= last < GROUP), starting at depthRow/colourRow
+// Coverage is exact, and every depth is the group's starting depth plus its lane offset with the vector
+// and scalar code doing the same float add, so which code ends up handling a pixel never changes its result
+// Returns true if any pixel was written
+// With COUNT the covered and written pixels are recorded in coverage, without it coverage is never touched
+#if !defined(RASTER_AVX2)
+template <bool COUNT>
+static bool fillGroupScalar(const GroupEdges &edges, float depth, const GroupOffsets &offsets, int first, int last,
+                            uint32_t colour, float *depthRow, uint32_t *colourRow, GroupCoverage &coverage) {
+	bool written = false;
+	for (int k = first; k <= last; k++) {
+		int32_t e0 = edges.edge0 + offsets.edge0[k];
+		int32_t e1 = edges.edge1 + offsets.edge1[k];
+		int32_t e2 = edges.edge2 + offsets.edge2[k];
+		if ((e0 | e1 | e2) >= 0) {
+			if (COUNT) coverage.tested |= 1u << k;
+			float pixelDepth = depth + offsets.depth[k];
+			if (pixelDepth > depthRow[k]) {
+				depthRow[k] = pixelDepth;
+				colourRow[k] = colour;
+				written = true;
+				if (COUNT) coverage.written |= 1u << k;
+			}
+		}
+	}
+	return written;
+}
+#endif
+
+#if defined(RASTER_AVX2)
+template <bool COUNT>
+static inline bool fillGroup(const GroupEdges &edges, float depth, const GroupOffsets &offsets, int first, int last,
+                             uint32_t colour, float *depthRow, uint32_t *colourRow, GroupCoverage &coverage) {
+	__m256i e0 = _mm256_add_epi32(_mm256_set1_epi32(edges.edge0), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(offsets.edge0)));
+	__m256i e1 = _mm256_add_epi32(_mm256_set1_epi32(edges.edge1), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(offsets.edge1)));
+	__m256i e2 = _mm256_add_epi32(_mm256_set1_epi32(edges.edge2), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(offsets.edge2)));
+	// A lane is inside when none of its edge functions has the sign bit set
+	__m256i inside = _mm256_cmpgt_epi32(_mm256_or_si256(_mm256_or_si256(e0, e1), e2), _mm256_set1_epi32(-1));
+	__m256 oldDepth;
+	if (first == 0 && last == GROUP - 1) {
+		if (_mm256_testz_si256(inside, inside)) return false;
+		oldDepth = _mm256_loadu_ps(depthRow);
+	} else {
+		// Lanes outside the group's range are masked off and the load never touches their memory
+		const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		__m256i valid = _mm256_and_si256(_mm256_cmpgt_epi32(lane, _mm256_set1_epi32(first - 1)),
+		                                 _mm256_cmpgt_epi32(_mm256_set1_epi32(last + 1), lane));
+		inside = _mm256_and_si256(inside, valid);
+		if (_mm256_testz_si256(inside, inside)) return false;
+		oldDepth = _mm256_maskload_ps(depthRow, valid);
+	}
+
+	__m256 pixelDepth = _mm256_add_ps(_mm256_set1_ps(depth), _mm256_loadu_ps(offsets.depth));
+	__m256 pass = _mm256_and_ps(_mm256_castsi256_ps(inside), _mm256_cmp_ps(pixelDepth, oldDepth, _CMP_GT_OQ));
+	int passMask = _mm256_movemask_ps(pass);
+	if (COUNT) {
+		coverage.tested = uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(inside)));
+		coverage.written = uint32_t(passMask);
+	}
+	if (passMask == 0) return false;
+	__m256i passBits = _mm256_castps_si256(pass);
+	_mm256_maskstore_ps(depthRow, passBits, pixelDepth);
+	_mm256_maskstore_epi32(reinterpret_cast<int *>(colourRow), passBits, _mm256_set1_epi32(colour));
+	return true;
+}
+#elif defined(RASTER_SSE2)
+template <bool COUNT>
+static bool fillGroup(const GroupEdges &edges, float depth, const GroupOffsets &offsets, int first, int last,
+                      uint32_t colour, float *depthRow, uint32_t *colourRow, GroupCoverage &coverage) {
+	bool written = false;
+	const __m128i outside = _mm_set1_epi32(-1);
+	const __m128i fillColour = _mm_set1_epi32(colour);
+	for (int start = 0; start < GROUP; start += LANES) {
+		int end = start + LANES - 1;
+		if (last < start || first > end) continue;
+		// Partly covered halves go through the scalar loop, which gives the same results
+		if (first > start || last < end) {
+			written |= fillGroupScalar<COUNT>(edges, depth, offsets, std::max(first, start), std::min(last, end), colour,
+			                                  depthRow, colourRow, coverage);
+			continue;
+		}
+		__m128i e0 = _mm_add_epi32(_mm_set1_epi32(edges.edge0), _mm_loadu_si128(reinterpret_cast<const __m128i *>(offsets.edge0 + start)));
+		__m128i e1 = _mm_add_epi32(_mm_set1_epi32(edges.edge1), _mm_loadu_si128(reinterpret_cast<const __m128i *>(offsets.edge1 + start)));
+		__m128i e2 = _mm_add_epi32(_mm_set1_epi32(edges.edge2), _mm_loadu_si128(reinterpret_cast<const __m128i *>(offsets.edge2 + start)));
+		__m128 inside = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_or_si128(_mm_or_si128(e0, e1), e2), outside));
+		int insideMask = _mm_movemask_ps(inside);
+		if (insideMask == 0) continue;
+		__m128 pixelDepth = _mm_add_ps(_mm_set1_ps(depth), _mm_loadu_ps(offsets.depth + start));
+		__m128 oldDepth = _mm_loadu_ps(depthRow + start);
+		__m128 pass = _mm_and_ps(inside, _mm_cmpgt_ps(pixelDepth, oldDepth));
+		int passMask = _mm_movemask_ps(pass);
+		if (COUNT) {
+			coverage.tested |= uint32_t(insideMask) << start;
+			coverage.written |= uint32_t(passMask) << start;
+		}
+		if (passMask == 0) continue;
+		_mm_storeu_ps(depthRow + start, _mm_or_ps(_mm_and_ps(pass, pixelDepth), _mm_andnot_ps(pass, oldDepth)));
+		__m128i *colourBlock = reinterpret_cast<__m128i *>(colourRow + start);
+		__m128i passBits = _mm_castps_si128(pass);
+		__m128i oldColour = _mm_loadu_si128(colourBlock);
+		_mm_storeu_si128(colourBlock, _mm_or_si128(_mm_and_si128(passBits, fillColour), _mm_andnot_si128(passBits, oldColour)));
+		written = true;
+	}
+	return written;
+}
+#else
+template <bool COUNT>
+static bool fillGroup(const GroupEdges &edges, float depth, const GroupOffsets &offsets, int first, int last,
+                      uint32_t colour, float *depthRow, uint32_t *colourRow, GroupCoverage &coverage) {
+	return fillGroupScalar<COUNT>(edges, depth, offsets, first, last, colour, depthRow, colourRow, coverage);
+}
+#endif
+
+// Adds a group starting at pixel (x, y) to the totals, and to the per-pixel counts if there are any
+static void countGroup(RasterStats &stats, int x, int y, const GroupCoverage &coverage) {
+	stats.pixelsTested += countLanes(coverage.tested);
+	stats.pixelsWritten += countLanes(coverage.written);
+	if (stats.testCounts == nullptr) return;
+	size_t start = size_t(y) * stats.countStride + x;
+	// Only covered lanes are touched, the others can be past the edge of the screen
+	for (int k = 0; k < GROUP; k++) {
+		if (coverage.tested & (1u << k)) stats.testCounts[start + k]++;
+		if (coverage.written & (1u << k)) stats.writeCounts[start + k]++;
+	}
+}
+
+// Pixels are filled in groups that line up with the 8x8 depth pyramid cells, and a cell is skipped
+// without touching any pixels when its farthest stored depth is already as close as the triangle gets there
+// A group's starting values are its row's values plus its column's, both worked out from the plane
+// equations, so they don't depend on which part of the triangle a caller asked for
+template <bool COUNT>
+static void fillTriangleGroups(const CanvasTriangle &triangle, const PixelRect &clip, uint32_t colour, const RasterBuffer &target,
+                               RasterStats &stats) {
+	PixelRect area = triangleBounds(triangle).intersect(clip);
+	if (area.isEmpty()) return;
+	TriangleSetup setup(triangle);
+	if (setup.isDegenerate) return;
+	DepthPyramid *pyramid = target.depthPyramid;
+	float triangleNearest = nearestDepth(triangle);
+	bool clampGroups = !edgesFitGroups(setup, area);
+
+	GroupOffsets offsets;
+	for (int k = 0; k < GROUP; k++) {
+		offsets.edge0[k] = setup.edgeStepX[0] * k;
+		offsets.edge1[k] = setup.edgeStepX[1] * k;
+		offsets.edge2[k] = setup.edgeStepX[2] * k;
+		offsets.depth[k] = setup.depthStepX * k;
+	}
+
+	int firstCellX = area.minX / GROUP;
+	int lastCellX = area.maxX / GROUP;
+	// Up to 64 cells across are handled at once, so which ones to visit fits in a bit mask
+	// and the per-column values fit on the stack
+	for (int chunkX = firstCellX; chunkX <= lastCellX; chunkX += 64) {
+		int chunkCells = std::min(lastCellX - chunkX + 1, 64);
+		int64_t columnEdges[64][3];
+		float columnDepth[64];
+		for (int i = 0; i < chunkCells; i++) {
+			int columnX = (chunkX + i) * GROUP;
+			for (int e = 0; e < 3; e++) columnEdges[i][e] = int64_t(setup.edgeStepX[e]) * columnX;
+			columnDepth[i] = setup.depthStepX * float(columnX - setup.origin.x);
+		}
+		int firstInCell = area.minX - firstCellX * GROUP;
+		int lastInCell = area.maxX - lastCellX * GROUP;
+
+		for (int cellY = area.minY / GROUP; cellY <= area.maxY / GROUP; cellY++) {
+			int top = std::max(area.minY, cellY * GROUP);
+			int bottom = std::min(area.maxY, cellY * GROUP + GROUP - 1);
+			uint64_t visible = 0;
+			for (int i = 0; i < chunkCells; i++) {
+				int cellX = chunkX + i;
+				if (pyramid != nullptr) {
+					// Depth is linear, so the closest it gets over the cell is at one of the corners
+					int left = std::max(area.minX, cellX * GROUP);
+					int right = std::min(area.maxX, cellX * GROUP + GROUP - 1);
+					float cornerNearest = std::max(std::max(setup.depthAt(left, top), setup.depthAt(right, top)),
+					                               std::max(setup.depthAt(left, bottom), setup.depthAt(right, bottom)));
+					float cellNearest = std::min(triangleNearest, conservativeDepth(cornerNearest));
+					if (cellNearest <= pyramid->farthestDepth(0, cellX, cellY)) continue;
+				}
+				visible |= uint64_t(1) << i;
+			}
+			if (visible == 0) continue;
+
+			uint64_t written = 0;
+			for (int y = top; y <= bottom; y++) {
+				int64_t rowEdges[3];
+				for (int e = 0; e < 3; e++) rowEdges[e] = setup.edge[e] + int64_t(setup.edgeStepY[e]) * y;
+				float rowDepth = setup.depth + setup.depthStepY * float(y - setup.origin.y);
+				size_t rowStart = (y - target.originY) * target.stride + (chunkX * GROUP - target.originX);
+				for (int i = 0; i < chunkCells; i++) {
+					uint64_t bit = uint64_t(1) << i;
+					if ((visible & bit) == 0) continue;
+					int cellX = chunkX + i;
+					int first = (cellX == firstCellX) ? firstInCell : 0;
+					int last = (cellX == lastCellX) ? lastInCell : GROUP - 1;
+					size_t groupStart = rowStart + i * GROUP;
+					GroupEdges edges = {int32_t(rowEdges[0] + columnEdges[i][0]), int32_t(rowEdges[1] + columnEdges[i][1]),
+					                    int32_t(rowEdges[2] + columnEdges[i][2])};
+					if (clampGroups) {
+						edges = {clampEdge(rowEdges[0] + columnEdges[i][0]), clampEdge(rowEdges[1] + columnEdges[i][1]),
+						         clampEdge(rowEdges[2] + columnEdges[i][2])};
+					}
+					GroupCoverage coverage{};
+					if (fillGroup<COUNT>(edges, rowDepth + columnDepth[i], offsets, first, last, colour,
+					                     target.depth + groupStart, target.colour + groupStart, coverage)) written |= bit;
+					if (COUNT) countGroup(stats, cellX * GROUP, y, coverage);
+				}
+			}
+			if (pyramid == nullptr) continue;
+			for (int i = 0; i < chunkCells; i++) {
+				if (written & (uint64_t(1) << i)) pyramid->updateCell(target, chunkX + i, cellY);
+			}
+		}
+	}
+}
+
+void fillTriangle(const CanvasTriangle &triangle, const PixelRect &clip, uint32_t colour, const RasterBuffer &target) {
+	// Counting is a separate instantiation so the usual fill doesn't pay for it
+	if (target.stats != nullptr) {
+		fillTriangleGroups<true>(triangle, clip, colour, target, *target.stats);
+	} else {
+		RasterStats unused;
+		fillTriangleGroups<false>(triangle, clip, colour, target, unused);
+	}
+}
+
+// floor(a / b) and ceil(a / b) for b > 0, rounding the right way for negative a too
+static int64_t floorDivide(int64_t a, int64_t b) {
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+static int64_t ceilDivide(int64_t a, int64_t b) {
+	return a >= 0 ? (a + b - 1) / b : -(-a / b);
+}
+
+// Each edge function is linear along a row, so edge >= 0 is a half-line of x
+// and the covered pixels of row y are one span that can be worked out exactly before filling it
+static bool coveredSpan(const TriangleSetup &setup, const PixelRect &area, int y, int &first, int &last) {
+	int64_t from = area.minX;
+	int64_t to = area.maxX;
+	for (int i = 0; i < 3; i++) {
+		int64_t edge = setup.edgeAt(i, 0, y);
+		int64_t step = setup.edgeStepX[i];
+		if (step > 0) from = std::max(from, ceilDivide(-edge, step));
+		else if (step < 0) to = std::min(to, floorDivide(edge, -step));
+		else if (edge < 0) return false;
+	}
+	first = int(from);
+	last = int(to);
+	return from <= to;
+}
+
+void fillTriangleColour(const CanvasTriangle &triangle, const PixelRect &clip, uint32_t colour, uint32_t *pixels, size_t stride) {
+	PixelRect area = triangleBounds(triangle).intersect(clip);
+	if (area.isEmpty()) return;
+	TriangleSetup setup(triangle);
+	if (setup.isDegenerate) return;
+	int first, last;
+	for (int y = area.minY; y <= area.maxY; y++) {
+		if (!coveredSpan(setup, area, y, first, last)) continue;
+		std::fill_n(pixels + y * stride + first, last - first + 1, colour);
+	}
+}
+
+// Texture coordinates (s, t) are 16.16 fixed point while they are stepped along a span
+static const int TEXEL_BITS = 16;
+static const float TEXEL_SCALE = float(1 << TEXEL_BITS);
+
+// A fixed point texture coordinate moved into [0, size) texels by whole turns of the texture
+static int64_t wrapTexel(int64_t coordinate, int64_t size) {
+	int64_t limit = size << TEXEL_BITS;
+	int64_t wrapped = coordinate % limit;
+	return wrapped < 0 ? wrapped + limit : wrapped;
+}
+
+void fillTriangleTextured(const CanvasTriangle &triangle, const PixelRect &clip, const TextureMap &texture,
+                          TextureAddressing addressing, uint32_t *pixels, size_t stride) {
+	if (texture.width == 0 || texture.height == 0) return;
+	PixelRect area = triangleBounds(triangle).intersect(clip);
+	if (area.isEmpty()) return;
+	TriangleSetup setup(triangle);
+	if (setup.isDegenerate) return;
+
+	// Planes through the vertices' texture coordinates, offset by half a texel so rounding down picks the nearest one
+	const CanvasPoint &p0 = triangle.vertices[0];
+	const CanvasPoint &p1 = triangle.vertices[1];
+	const CanvasPoint &p2 = triangle.vertices[2];
+	glm::vec3 us(p0.texturePoint.x, p1.texturePoint.x, p2.texturePoint.x);
+	glm::vec3 vs(p0.texturePoint.y, p1.texturePoint.y, p2.texturePoint.y);
+	float uOrigin = us[0] + 0.5f;
+	float vOrigin = vs[0] + 0.5f;
+	float uStepX = glm::dot(setup.weightStepX, us);
+	float uStepY = glm::dot(setup.weightStepY, us);
+	float vStepX = glm::dot(setup.weightStepX, vs);
+	float vStepY = glm::dot(setup.weightStepY, vs);
+
+	int64_t width = int64_t(texture.width);
+	int64_t height = int64_t(texture.height);
+	int64_t uLimit = width << TEXEL_BITS;
+	int64_t vLimit = height << TEXEL_BITS;
+	int64_t uStep = std::llrint(uStepX * TEXEL_SCALE);
+	int64_t vStep = std::llrint(vStepX * TEXEL_SCALE);
+	// Wrapped steps are less than a whole texture, so one subtraction per pixel keeps the coordinates inside it
+	if (addressing == TEXTURE_WRAP) {
+		uStep = wrapTexel(uStep, width);
+		vStep = wrapTexel(vStep, height);
+	}
+	const uint32_t *texels = texture.pixels.data();
+
+	int first, last;
+	for (int y = area.minY; y <= area.maxY; y++) {
+		if (!coveredSpan(setup, area, y, first, last)) continue;
+		// Each span starts from the planes, so rounding in the steps can't build up down the triangle
+		float dx = float(first) - setup.origin.x;
+		float dy = float(y) - setup.origin.y;
+		int64_t s = std::llrint((uOrigin + uStepX * dx + uStepY * dy) * TEXEL_SCALE);
+		int64_t t = std::llrint((vOrigin + vStepX * dx + vStepY * dy) * TEXEL_SCALE);
+		uint32_t *row = pixels + y * stride;
+		if (addressing == TEXTURE_WRAP) {
+			s = wrapTexel(s, width);
+			t = wrapTexel(t, height);
+			for (int x = first; x <= last; x++) {
+				row[x] = texels[(t >> TEXEL_BITS) * width + (s >> TEXEL_BITS)];
+				s += uStep;
+				if (s >= uLimit) s -= uLimit;
+				t += vStep;
+				if (t >= vLimit) t -= vLimit;
+			}
+		} else {
+			for (int x = first; x <= last; x++) {
+				int64_t column = std::min(std::max(s >> TEXEL_BITS, int64_t(0)), width - 1);
+				int64_t line = std::min(std::max(t >> TEXEL_BITS, int64_t(0)), height - 1);
+				row[x] = texels[line * width + column];
+				s += uStep;
+				t += vStep;
+			}
+		}
+	}
+}
+
+// The points are worked out from the start of the line rather than accumulated, so long lines don't drift
+void rasteriseLine(const CanvasPoint &from, const CanvasPoint &to, const PixelRect &clip, uint32_t colour, const RasterBuffer &target) {
+	float xDistance = to.x - from.x;
+	float yDistance = to.y - from.y;
+	float depthDistance = to.depth - from.depth;
+	float steps = std::max(std::abs(xDistance), std::abs(yDistance));
+	float xStep = steps > 0 ? xDistance / steps : 0.0f;
+	float yStep = steps > 0 ? yDistance / steps : 0.0f;
+	float depthStep = steps > 0 ? depthDistance / steps : 0.0f;
+	for (int i = 0; i <= steps; i++) {
+		float x = from.x + xStep * i;
+		float y = from.y + yStep * i;
+		// Lines can reach into the guard band around the window, skip the points outside the clip rectangle
+		if (x < clip.minX || y < clip.minY) continue;
+		int px = int(x);
+		int py = int(y);
+		if (px > clip.maxX || py > clip.maxY) continue;
+		size_t index = size_t(py - target.originY) * target.stride + size_t(px - target.originX);
+		float depth = from.depth + depthStep * i;
+		if (depth > target.depth[index]) {
+			target.depth[index] = depth;
+			target.colour[index] = colour;
+		}
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "CanvasTriangle.h"
+
+class DepthPyramid;
+class TextureMap;
+
+// An inclusive rectangle of pixel coordinates
+struct PixelRect {
+	int minX{};
+	int minY{};
+	int maxX{-1};
+	int maxY{-1};
+
+	PixelRect();
+	PixelRect(int left, int top, int right, int bottom);
+	bool isEmpty() const;
+	PixelRect intersect(const PixelRect &other) const;
+};
+
+// Projected vertex positions are snapped to 28.4 fixed point (1/16th of a pixel) before rasterising,
+// so coverage is worked out with exact integer arithmetic
+// Coordinates are clamped to +-2^18 pixels first, the guard band keeps real triangles far inside that
+static const int SUBPIXEL_BITS = 4;
+static const int SUBPIXEL_SCALE = 1 << SUBPIXEL_BITS;
+int32_t toFixedPoint(float coordinate);
+
+// The pixels whose sample points (x, y) could be covered by a projected triangle (not clipped to anything)
+PixelRect triangleBounds(const CanvasTriangle &triangle);
+
+// Edge equations and depth plane of a projected triangle, worked out once per triangle
+// The edge functions are exact integers in 1/256ths of a square pixel and the depth is linear in x and y,
+// so the pixel loop only has to add the steps
+// Pixel (x, y) is covered when all three edge functions are >= 0 there. A sample exactly on an edge only counts
+// for top and left edges (the top-left rule), so on an edge shared by two triangles every pixel is filled exactly once
+struct TriangleSetup {
+	// Edge function of the edge opposite each vertex at pixel (0, 0) with the fill rule bias folded in,
+	// and how much it changes per pixel in x and y
+	int64_t edge[3]{};
+	int32_t edgeStepX[3]{};
+	int32_t edgeStepY[3]{};
+	// How much each vertex's barycentric weight changes per pixel in x and y, for interpolating anything else
+	glm::vec3 weightStepX{};
+	glm::vec3 weightStepY{};
+	// Depth at the first vertex, and how much it changes per pixel in x and y
+	glm::vec2 origin{};
+	float depth{};
+	float depthStepX{};
+	float depthStepY{};
+	bool isDegenerate{};
+
+	TriangleSetup(const CanvasTriangle &triangle);
+	int64_t edgeAt(int i, int x, int y) const;
+	bool covers(int x, int y) const;
+	float depthAt(int x, int y) const;
+};
+
+// An upper bound on the depth of any pixel of the triangle, i.e. the closest it can get to the camera
+float nearestDepth(const CanvasTriangle &triangle);
+
+// Pixel counts fillTriangle adds to when a RasterBuffer has somewhere to put them
+// Tested pixels are the ones a triangle covers, written pixels are the ones of those that passed the depth test
+// With testCounts and writeCounts set every pixel's own counts go up too, they are indexed in screen coordinates
+// (y * countStride + x) whatever the buffer's origin, so per-tile buffers can share one pair of arrays
+struct RasterStats {
+	uint64_t pixelsTested = 0;
+	uint64_t pixelsWritten = 0;
+	uint32_t *testCounts{};
+	uint32_t *writeCounts{};
+	size_t countStride{};
+
+	// Adds the totals, the per-pixel counts are already wherever they were counted
+	void add(const RasterStats &other);
+};
+
+// Colour and depth storage that a triangle is filled into
+// Both are row-major with the same stride, and element 0 is pixel (originX, originY)
+// The optional depth pyramid (in screen coordinates) lets hidden 8x8 cells be skipped and is kept up to date
+// The optional stats are only counted when attached, without them the fill runs exactly as fast as before
+struct RasterBuffer {
+	uint32_t *colour{};
+	float *depth{};
+	size_t stride{};
+	int originX{};
+	int originY{};
+	DepthPyramid *depthPyramid{};
+	RasterStats *stats{};
+
+	RasterBuffer();
+	RasterBuffer(uint32_t *colourData, float *depthData, size_t rowStride, int x = 0, int y = 0, DepthPyramid *pyramid = nullptr);
+};
+
+// Fills the part of the triangle that lies inside the clip rectangle, keeping pixels whose
+// interpolated depth is greater (closer) than the one already in the buffer
+// Uses an AVX2 (8 pixel) or SSE2 (4 pixel) kernel when the compiler targets one, and a scalar loop otherwise
+// Serial and tiled rendering both go through here so they produce exactly the same pixels
+// Only level 0 of the depth pyramid is updated, callers propagate it upwards with DepthPyramid::propagate
+void fillTriangle(const CanvasTriangle &triangle, const PixelRect &clip, uint32_t colour, const RasterBuffer &target);
+
+// Sets every pixel the triangle covers inside the clip rectangle to colour, with no depth test
+// pixels is row-major with the given stride and element 0 is pixel (0, 0)
+void fillTriangleColour(const CanvasTriangle &triangle, const PixelRect &clip, uint32_t colour, uint32_t *pixels, size_t stride);
+
+// What happens to texture coordinates that fall outside the texture
+enum TextureAddressing { TEXTURE_CLAMP, TEXTURE_WRAP };
+
+// Covers the same pixels as fillTriangleColour, each taking the nearest texel to the vertices' texturePoints
+// (in texels) interpolated across the triangle. The texture is read in place and nothing is allocated
+// Coordinates are stepped along each span in fixed point, so a pixel costs a few adds and the addressing
+void fillTriangleTextured(const CanvasTriangle &triangle, const PixelRect &clip, const TextureMap &texture,
+                          TextureAddressing addressing, uint32_t *pixels, size_t stride);
+
+// Draws a line a pixel per step along its longer axis (a DDA), interpolating depth along it and keeping
+// the pixels that pass the same depth test as fillTriangle. Allocates nothing and leaves the depth pyramid alone,
+// which is safe because it only ever makes the pyramid think a cell is farther away than it is
+void rasteriseLine(const CanvasPoint &from, const CanvasPoint &to, const PixelRect &clip, uint32_t colour, const RasterBuffer &target);
+
+// Name and width of the kernel fillTriangle was built with (e.g. "avx2", 8)
+const char *rasterKernelName();
+int rasterKernelWidth();
@@ -1,4 +1,6 @@
+#include <cmath>
 #include "RayTriangleIntersection.h"
+#include "IndexedMesh.h"
 
 RayTriangleIntersection::RayTriangleIntersection() = default;
 RayTriangleIntersection::RayTriangleIntersection(const glm::vec3 &point, float distance, const ModelTriangle &triangle, size_t index) :
@@ -13,3 +15,34 @@ std::ostream &operator<<(std::ostream &os, const RayTriangleIntersection &inters
 	   " at a distance of " << intersection.distanceFromCamera;
 	return os;
 }
+
+bool findClosestIntersection(const MeshView &mesh, const glm::vec3 &origin, const glm::vec3 &direction,
+                             RayTriangleIntersection &closest, float minDistance) {
+	float nearest = INFINITY;
+	size_t hit = 0;
+	for (size_t i = 0; i < mesh.triangleCount(); i++) {
+		// Moller-Trumbore: solve origin + t * direction = v0 + u * e0 + v * e1 for t, u and v
+		glm::vec3 v0 = mesh.vertices[mesh.indices[3 * i]];
+		glm::vec3 e0 = mesh.vertices[mesh.indices[3 * i + 1]] - v0;
+		glm::vec3 e1 = mesh.vertices[mesh.indices[3 * i + 2]] - v0;
+		glm::vec3 p = glm::cross(direction, e1);
+		float determinant = glm::dot(e0, p);
+		// The ray runs along the triangle's plane
+		if (std::fabs(determinant) < 1e-12f) continue;
+		float inverse = 1.0f / determinant;
+		glm::vec3 s = origin - v0;
+		float u = glm::dot(s, p) * inverse;
+		if (u < 0.0f || u > 1.0f) continue;
+		glm::vec3 q = glm::cross(s, e0);
+		float v = glm::dot(direction, q) * inverse;
+		if (v < 0.0f || u + v > 1.0f) continue;
+		float t = glm::dot(e1, q) * inverse;
+		if (t > minDistance && t < nearest) {
+			nearest = t;
+			hit = i;
+		}
+	}
+	if (nearest == INFINITY) return false;
+	closest = RayTriangleIntersection(origin + nearest * direction, nearest, mesh.triangle(hit), hit);
+	return true;
+}
@@ -14,3 +14,12 @@ struct RayTriangleIntersection {
 	RayTriangleIntersection(const glm::vec3 &point, float distance, const ModelTriangle &triangle, size_t index);
 	friend std::ostream &operator<<(std::ostream &os, const RayTriangleIntersection &intersection);
 };
+
+struct MeshView;
+
+// The nearest triangle of the mesh hit by the ray origin + t * direction with t > minDistance, as closest
+// distanceFromCamera is that t, so it is a true distance when direction has a length of 1
+// Only the positions and indices are read to find it, the ModelTriangle is put together for the one that was hit
+// Returns false, leaving closest alone, if the ray misses every triangle
+bool findClosestIntersection(const MeshView &mesh, const glm::vec3 &origin, const glm::vec3 &direction,
+                             RayTriangleIntersection &closest, float minDistance = 1e-4f);
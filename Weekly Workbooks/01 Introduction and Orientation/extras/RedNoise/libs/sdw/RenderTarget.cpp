@@ -0,0 +1,71 @@
+#include <algorithm>
+#include "RenderTarget.h"
+
+RenderTarget::RenderTarget(size_t w, size_t h) :
+		targetWidth(w), targetHeight(h), colour(w * h, 0), depth(w * h, 0.0f), pyramid(w, h) {}
+
+void RenderTarget::resize(size_t w, size_t h) {
+	targetWidth = w;
+	targetHeight = h;
+	colour.assign(w * h, 0);
+	depth.assign(w * h, 0.0f);
+	pyramid = DepthPyramid(w, h);
+}
+
+size_t RenderTarget::width() const {
+	return targetWidth;
+}
+
+size_t RenderTarget::height() const {
+	return targetHeight;
+}
+
+PixelRect RenderTarget::bounds() const {
+	return PixelRect(0, 0, int(targetWidth) - 1, int(targetHeight) - 1);
+}
+
+bool RenderTarget::contains(int x, int y) const {
+	return x >= 0 && y >= 0 && size_t(x) < targetWidth && size_t(y) < targetHeight;
+}
+
+void RenderTarget::clear(uint32_t fillColour, float fillDepth) {
+	std::fill(colour.begin(), colour.end(), fillColour);
+	clearDepth(fillDepth);
+}
+
+void RenderTarget::clearDepth(float fillDepth) {
+	std::fill(depth.begin(), depth.end(), fillDepth);
+	pyramid.clear(fillDepth);
+}
+
+uint32_t *RenderTarget::colourData() {
+	return colour.data();
+}
+
+const uint32_t *RenderTarget::colourData() const {
+	return colour.data();
+}
+
+float *RenderTarget::depthData() {
+	return depth.data();
+}
+
+const float *RenderTarget::depthData() const {
+	return depth.data();
+}
+
+uint32_t &RenderTarget::colourAt(int x, int y) {
+	return colour[y * targetWidth + x];
+}
+
+float &RenderTarget::depthAt(int x, int y) {
+	return depth[y * targetWidth + x];
+}
+
+DepthPyramid &RenderTarget::depthPyramid() {
+	return pyramid;
+}
+
+RasterBuffer RenderTarget::buffer() {
+	return RasterBuffer(colour.data(), depth.data(), targetWidth, 0, 0, &pyramid);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "DepthPyramid.h"
+#include "Rasteriser.h"
+
+// Colour and depth for an image whose size is chosen at runtime
+// Both are stored row-major with no padding, so a row is width values and pixel (x, y) is at y * width + x
+// Depths are 1/z like everywhere else, so larger is closer and 0 is infinitely far away
+// The depth pyramid over the depth buffer lives here too, so clearing one clears the other
+class RenderTarget {
+public:
+	RenderTarget(size_t w, size_t h);
+	// Changes the size, everything is cleared to black and infinitely far away
+	void resize(size_t w, size_t h);
+	size_t width() const;
+	size_t height() const;
+	PixelRect bounds() const;
+	bool contains(int x, int y) const;
+
+	// Whole-buffer fills that the compiler turns into wide stores (or a memset for zero)
+	void clear(uint32_t colour = 0, float depth = 0.0f);
+	void clearDepth(float depth = 0.0f);
+
+	uint32_t *colourData();
+	const uint32_t *colourData() const;
+	float *depthData();
+	const float *depthData() const;
+	// No bounds checking, use contains first if the pixel could be off the image
+	uint32_t &colourAt(int x, int y);
+	float &depthAt(int x, int y);
+	DepthPyramid &depthPyramid();
+	// The whole target as something fillTriangle can draw into, with the depth pyramid attached
+	RasterBuffer buffer();
+
+private:
+	size_t targetWidth;
+	size_t targetHeight;
+	std::vector<uint32_t> colour;
+	std::vector<float> depth;
+	DepthPyramid pyramid;
+};
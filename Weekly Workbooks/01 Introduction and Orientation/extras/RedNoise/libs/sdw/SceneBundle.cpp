@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "SceneBundle.h"
+
+// What the file starts with, every number is in the byte order of the machine that wrote it
+// Each section starts on a SECTION_ALIGNMENT boundary, at the offset given for it here
+enum Section { X, Y, Z, INDICES, NORMALS, MATERIALS, TEXTURE_COORDINATES, MATERIAL_TABLE, MATERIAL_NAMES, TEXTURE, SECTION_COUNT };
+struct BundleHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint64_t vertexCount;
+	uint64_t triangleCount;
+	// 0 or 1, whether the mesh has three texture coordinates per triangle
+	uint64_t textureCoordinates;
+	uint64_t materialCount;
+	// Length of the MATERIAL_NAMES section, every material's name back to back
+	uint64_t materialNameBytes;
+	uint64_t textureWidth;
+	uint64_t textureHeight;
+	uint64_t offsets[SECTION_COUNT];
+};
+// One entry of the material table, its name is nameLength bytes from nameOffset in the MATERIAL_NAMES section
+struct BundleMaterial {
+	uint32_t nameOffset;
+	uint32_t nameLength;
+	int32_t red;
+	int32_t green;
+	int32_t blue;
+};
+
+static const char MAGIC[8] = {'S', 'D', 'W', 'S', 'C', 'E', 'N', 'E'};
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+static const uint64_t SECTION_ALIGNMENT = 64;
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "normals are read straight out of the file as glm::vec3s");
+static_assert(sizeof(glm::vec2) == 2 * sizeof(float), "texture coordinates are read straight out of the file as glm::vec2s");
+
+static uint64_t alignSection(uint64_t offset) {
+	return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+// How many bytes each section takes up for a scene of this size
+static void sectionSizes(const BundleHeader &header, uint64_t sizes[SECTION_COUNT]) {
+	sizes[X] = sizes[Y] = sizes[Z] = header.vertexCount * sizeof(float);
+	sizes[INDICES] = header.triangleCount * 3 * sizeof(uint32_t);
+	sizes[NORMALS] = header.triangleCount * sizeof(glm::vec3);
+	sizes[MATERIALS] = header.triangleCount * sizeof(uint32_t);
+	sizes[TEXTURE_COORDINATES] = header.textureCoordinates ? header.triangleCount * 3 * sizeof(glm::vec2) : 0;
+	sizes[MATERIAL_TABLE] = header.materialCount * sizeof(BundleMaterial);
+	sizes[MATERIAL_NAMES] = header.materialNameBytes;
+	sizes[TEXTURE] = header.textureWidth * header.textureHeight * sizeof(uint32_t);
+}
+
+SceneBundle::SceneBundle(const std::string &filename) : file(filename) {
+	if (!file.isOpen()) {
+		problem = "can't open " + filename;
+		return;
+	}
+	BundleHeader header;
+	if (file.size() < sizeof(header)) {
+		problem = filename + " is too short to be a scene bundle";
+		return;
+	}
+	std::memcpy(&header, file.data(), sizeof(header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+		problem = filename + " is not a scene bundle";
+		return;
+	}
+	if (header.byteOrder != BYTE_ORDER_MARK) {
+		problem = filename + " was written on a machine with a different byte order";
+		return;
+	}
+	if (header.version != SCENE_BUNDLE_VERSION) {
+		problem = filename + " is version " + std::to_string(header.version) + " of the bundle format, this reads version " +
+		          std::to_string(SCENE_BUNDLE_VERSION);
+		return;
+	}
+	// Counts this big would overflow the size sums below, and no real scene comes close
+	const uint64_t LIMIT = uint64_t(1) << 32;
+	if (header.vertexCount >= LIMIT || header.triangleCount >= LIMIT || header.materialCount >= LIMIT ||
+	    header.materialNameBytes >= LIMIT || header.textureWidth >= LIMIT / 4 || header.textureHeight >= LIMIT / 4) {
+		problem = filename + " is damaged, its counts are impossibly large";
+		return;
+	}
+	uint64_t sizes[SECTION_COUNT];
+	sectionSizes(header, sizes);
+	for (int section = 0; section < SECTION_COUNT; section++) {
+		uint64_t offset = header.offsets[section];
+		if (offset % SECTION_ALIGNMENT != 0 || offset < sizeof(header) || offset > file.size() || sizes[section] > file.size() - offset) {
+			problem = filename + " is damaged, section " + std::to_string(section) + " is not inside the file";
+			return;
+		}
+	}
+
+	const char *base = file.data();
+	view.vertices = VertexView(reinterpret_cast<const float *>(base + header.offsets[X]),
+	                           reinterpret_cast<const float *>(base + header.offsets[Y]),
+	                           reinterpret_cast<const float *>(base + header.offsets[Z]), size_t(header.vertexCount));
+	view.indices = reinterpret_cast<const uint32_t *>(base + header.offsets[INDICES]);
+	view.normals = reinterpret_cast<const glm::vec3 *>(base + header.offsets[NORMALS]);
+	view.materials = reinterpret_cast<const uint32_t *>(base + header.offsets[MATERIALS]);
+	if (header.textureCoordinates) view.textureCoordinates = reinterpret_cast<const glm::vec2 *>(base + header.offsets[TEXTURE_COORDINATES]);
+	view.triangles = size_t(header.triangleCount);
+	// The only thing read through rather than pointed at, a handful of names and colours
+	const BundleMaterial *table = reinterpret_cast<const BundleMaterial *>(base + header.offsets[MATERIAL_TABLE]);
+	const char *names = base + header.offsets[MATERIAL_NAMES];
+	for (size_t i = 0; i < header.materialCount; i++) {
+		const BundleMaterial &material = table[i];
+		if (material.nameOffset > header.materialNameBytes || material.nameLength > header.materialNameBytes - material.nameOffset) {
+			problem = filename + " is damaged, the name of material " + std::to_string(i) + " is not inside the file";
+			return;
+		}
+		palette.add(Colour(std::string(names + material.nameOffset, material.nameLength), material.red, material.green, material.blue));
+	}
+	// The writer saves a table with one entry per name, so fewer here means two entries had the same name
+	if (palette.size() != header.materialCount) {
+		problem = filename + " is damaged, two materials have the same name";
+		return;
+	}
+	view.materialTable = &palette;
+	texWidth = size_t(header.textureWidth);
+	texHeight = size_t(header.textureHeight);
+	texels = texWidth * texHeight > 0 ? reinterpret_cast<const uint32_t *>(base + header.offsets[TEXTURE]) : nullptr;
+
+	// A damaged index would send the renderer outside the arrays, so they are checked once here
+	uint32_t vertexLimit = uint32_t(header.vertexCount);
+	uint32_t materialLimit = uint32_t(palette.size());
+	uint32_t badIndices = 0;
+	uint32_t badMaterials = 0;
+	for (size_t i = 0; i < 3 * view.triangles; i++) badIndices |= uint32_t(view.indices[i] >= vertexLimit);
+	for (size_t i = 0; i < view.triangles; i++) badMaterials |= uint32_t(view.materials[i] >= materialLimit);
+	if (badIndices || badMaterials) {
+		problem = filename + " is damaged, a triangle refers to a " + (badIndices ? "vertex" : "material") + " that doesn't exist";
+		view = MeshView();
+		texels = nullptr;
+		texWidth = texHeight = 0;
+	}
+}
+
+bool SceneBundle::isOpen() const {
+	return problem.empty();
+}
+
+const std::string &SceneBundle::error() const {
+	return problem;
+}
+
+const MeshView &SceneBundle::mesh() const {
+	return view;
+}
+
+const MaterialTable &SceneBundle::materials() const {
+	return palette;
+}
+
+size_t SceneBundle::textureWidth() const {
+	return texWidth;
+}
+
+size_t SceneBundle::textureHeight() const {
+	return texHeight;
+}
+
+const uint32_t *SceneBundle::texturePixels() const {
+	return texels;
+}
+
+// Writes the bytes of one section and pads it out to where the next one starts
+static void writeSection(std::ofstream &output, const void *bytes, uint64_t size) {
+	static const char padding[SECTION_ALIGNMENT] = {};
+	if (size > 0) output.write(static_cast<const char *>(bytes), std::streamsize(size));
+	output.write(padding, std::streamsize(alignSection(size) - size));
+}
+
+bool writeSceneBundle(const std::string &filename, const MeshView &mesh, const TextureMap *texture, std::string &error) {
+	std::vector<BundleMaterial> table(mesh.materialTable->size());
+	std::string names;
+	for (uint32_t i = 0; i < table.size(); i++) {
+		const Colour &colour = (*mesh.materialTable)[i];
+		table[i].nameOffset = uint32_t(names.size());
+		table[i].nameLength = uint32_t(colour.name.size());
+		names += colour.name;
+		table[i].red = colour.red;
+		table[i].green = colour.green;
+		table[i].blue = colour.blue;
+	}
+
+	BundleHeader header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = SCENE_BUNDLE_VERSION;
+	header.byteOrder = BYTE_ORDER_MARK;
+	header.vertexCount = mesh.vertices.size();
+	header.triangleCount = mesh.triangleCount();
+	header.textureCoordinates = mesh.textureCoordinates != nullptr;
+	header.materialCount = table.size();
+	header.materialNameBytes = names.size();
+	bool textured = texture && texture->width * texture->height > 0;
+	header.textureWidth = textured ? texture->width : 0;
+	header.textureHeight = textured ? texture->height : 0;
+	uint64_t sizes[SECTION_COUNT];
+	sectionSizes(header, sizes);
+	uint64_t offset = alignSection(sizeof(header));
+	for (int section = 0; section < SECTION_COUNT; section++) {
+		header.offsets[section] = offset;
+		offset += alignSection(sizes[section]);
+	}
+
+	std::ofstream output(filename, std::ofstream::binary);
+	if (!output) {
+		error = "can't write " + filename;
+		return false;
+	}
+	writeSection(output, &header, sizeof(header));
+	writeSection(output, mesh.vertices.x, sizes[X]);
+	writeSection(output, mesh.vertices.y, sizes[Y]);
+	writeSection(output, mesh.vertices.z, sizes[Z]);
+	writeSection(output, mesh.indices, sizes[INDICES]);
+	writeSection(output, mesh.normals, sizes[NORMALS]);
+	writeSection(output, mesh.materials, sizes[MATERIALS]);
+	writeSection(output, mesh.textureCoordinates, sizes[TEXTURE_COORDINATES]);
+	writeSection(output, table.data(), sizes[MATERIAL_TABLE]);
+	writeSection(output, names.data(), sizes[MATERIAL_NAMES]);
+	writeSection(output, textured ? texture->pixels.data() : nullptr, sizes[TEXTURE]);
+	if (!output.flush()) {
+		error = "ran out of room writing " + filename;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "IndexedMesh.h"
+#include "MappedFile.h"
+#include "MaterialTable.h"
+#include "TextureMap.h"
+
+// Bumped whenever the layout changes, bundles of any other version are refused rather than misread
+const uint32_t SCENE_BUNDLE_VERSION = 3;
+
+// A scene saved by writeSceneBundle, mapped into memory and used where it lies: the mesh arrays and texture pixels
+// point straight into the file, so opening one costs a few checks and a pass over the indices however big the scene is
+// A bundle is only readable on machines with the byte order of the one that wrote it
+class SceneBundle {
+public:
+	explicit SceneBundle(const std::string &filename);
+
+	// False if the file couldn't be opened or isn't a bundle this version can read, error() says why
+	bool isOpen() const;
+	const std::string &error() const;
+	// Only valid while the bundle is, the mesh's materialTable is materials()
+	const MeshView &mesh() const;
+	const MaterialTable &materials() const;
+	// ARGB pixels row by row like TextureMap's, 0 x 0 with no pixels if the scene was saved without a texture
+	size_t textureWidth() const;
+	size_t textureHeight() const;
+	const uint32_t *texturePixels() const;
+
+private:
+	MappedFile file;
+	std::string problem;
+	MeshView view;
+	MaterialTable palette;
+	size_t texWidth = 0;
+	size_t texHeight = 0;
+	const uint32_t *texels = nullptr;
+};
+
+// Saves the mesh, its material table and the texture (if there is one) as a bundle
+// Returns false, with error set, if the file can't be written
+bool writeSceneBundle(const std::string &filename, const MeshView &mesh, const TextureMap *texture, std::string &error);
@@ -0,0 +1,26 @@
+#include "TextureCache.h"
+
+std::shared_ptr<const TextureMap> TextureCache::get(const std::string &filename) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto found = textures.find(filename);
+	if (found != textures.end()) return found->second;
+	// Decoded while holding the lock, so two threads asking for the same new texture don't both decode it
+	std::shared_ptr<const TextureMap> texture = std::make_shared<const TextureMap>(filename);
+	textures.emplace(filename, texture);
+	return texture;
+}
+
+void TextureCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	textures.clear();
+}
+
+size_t TextureCache::size() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return textures.size();
+}
+
+TextureCache &textureCache() {
+	static TextureCache cache;
+	return cache;
+}
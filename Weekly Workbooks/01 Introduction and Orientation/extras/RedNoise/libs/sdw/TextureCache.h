@@ -0,0 +1,26 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "TextureMap.h"
+
+// Textures decoded once per path and shared read-only from then on, so drawing with one never goes back to the disk
+// Safe to use from several threads at once
+class TextureCache {
+public:
+	// The texture in the PPM file, decoded on the first call for that path
+	// Throws std::invalid_argument like TextureMap, and caches nothing, if the file can't be read
+	std::shared_ptr<const TextureMap> get(const std::string &filename);
+	// Forgets every texture, those still held elsewhere stay valid until they are let go
+	void clear();
+	size_t size() const;
+
+private:
+	mutable std::mutex mutex;
+	std::unordered_map<std::string, std::shared_ptr<const TextureMap>> textures;
+};
+
+// The cache the whole program shares
+TextureCache &textureCache();
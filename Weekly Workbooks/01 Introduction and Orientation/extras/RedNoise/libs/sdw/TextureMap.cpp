@@ -1,34 +1,85 @@
 #include "TextureMap.h"
-#include <filesystem>
+#include <algorithm>
+#include "MappedFile.h"
 
-TextureMap::TextureMap() = default;
-TextureMap::TextureMap(const std::string &filename) {
-	std::ifstream inputStream(filename, std::ifstream::binary);
-	if(! inputStream) std::cout << "The file " << filename << " cannot be accessed by the TextureMap class...\nThis is usually because the PPM file is in the wrong folder\nOr you are passing in the wrong relative path" << std::endl;
-	std::string nextLine;
-	// Get the "P6" magic number
-	std::getline(inputStream, nextLine);
-	// Read the width and height line
-	std::getline(inputStream, nextLine);
-	// Skip over any comment lines !
-	while (nextLine.at(0) == '#') std::getline(inputStream, nextLine);
-	auto widthAndHeight = split(nextLine, ' ');
-	if (widthAndHeight.size() != 2)
-		throw std::invalid_argument("Failed to parse width and height line, line was `" + nextLine + "`");
+#if !defined(SDW_SCALAR_RASTER) && defined(__SSSE3__)
+#include <tmmintrin.h>
+#define CONVERT_SSSE3
+#endif
 
-	width = std::stoi(widthAndHeight[0]);
-	height = std::stoi(widthAndHeight[1]);
-	// Read the max value (which we assume is 255)
-	std::getline(inputStream, nextLine);
+// Packs count RGB byte triples into fully opaque 0xAARRGGBB pixels
+static void convertRGBToARGB(const uint8_t *rgb, uint32_t *argb, size_t count) {
+	size_t i = 0;
+#if defined(CONVERT_SSSE3)
+	// 16 pixels are exactly three loads, which are realigned so each vector starts on a pixel
+	// and then shuffled from R, G, B to B, G, R, A byte order (0xAARRGGBB in little-endian memory)
+	const __m128i order = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+	const __m128i alpha = _mm_set1_epi32(int(0xFF000000));
+	for (; i + 16 <= count; i += 16) {
+		const uint8_t *source = rgb + 3 * i;
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 16));
+		__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 32));
+		__m128i pixels[4] = {a, _mm_alignr_epi8(b, a, 12), _mm_alignr_epi8(c, b, 8), _mm_srli_si128(c, 4)};
+		for (int j = 0; j < 4; j++) {
+			__m128i packed = _mm_or_si128(_mm_shuffle_epi8(pixels[j], order), alpha);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(argb + i + 4 * j), packed);
+		}
+	}
+#endif
+	for (; i < count; i++) argb[i] = (255u << 24) + (uint32_t(rgb[3 * i]) << 16) + (uint32_t(rgb[3 * i + 1]) << 8) + rgb[3 * i + 2];
+}
+
+// Moves p past whitespace and # comments, which a PPM header can have between any two of its fields
+static const char *skipHeaderSpace(const char *p, const char *end) {
+	while (p < end) {
+		if (*p == '#') {
+			while (p < end && *p != '\n') p++;
+		} else if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+			p++;
+		} else {
+			break;
+		}
+	}
+	return p;
+}
 
-	pixels.resize(width * height);
-	for (size_t i = 0; i < width * height; i++) {
-		int red = inputStream.get();
-		int green = inputStream.get();
-		int blue = inputStream.get();
-		pixels[i] = ((255 << 24) + (red << 16) + (green << 8) + (blue));
+static bool readHeaderNumber(const char *&p, const char *end, size_t &value) {
+	p = skipHeaderSpace(p, end);
+	if (p == end || *p < '0' || *p > '9') return false;
+	value = 0;
+	for (; p < end && *p >= '0' && *p <= '9'; p++) value = std::min(value * 10 + size_t(*p - '0'), size_t(1) << 20);
+	return true;
+}
+
+// Decodes a binary (P6) PPM with one byte per channel, returns what is wrong with it or "" if nothing is
+static std::string decodePPM(const char *begin, const char *end, TextureMap &texture) {
+	const char *p = begin;
+	size_t maximum = 0;
+	if (end - p < 2 || p[0] != 'P' || p[1] != '6') return "it is not a binary (P6) PPM file";
+	p += 2;
+	if (!readHeaderNumber(p, end, texture.width) || !readHeaderNumber(p, end, texture.height) || !readHeaderNumber(p, end, maximum))
+		return "its header doesn't give a width, height and maximum value";
+	if (maximum == 0 || maximum > 255) return "it has more than one byte per channel";
+	// Exactly one whitespace character separates the header from the pixels
+	p++;
+	size_t count = texture.width * texture.height;
+	if (p > end || size_t(end - p) < 3 * count) return "it is too short for its size";
+	texture.pixels.resize(count);
+	convertRGBToARGB(reinterpret_cast<const uint8_t *>(p), texture.pixels.data(), count);
+	return "";
+}
+
+TextureMap::TextureMap() = default;
+TextureMap::TextureMap(const std::string &filename) {
+	MappedFile file(filename);
+	// Loading can happen on any thread through TextureCache, so the whole message goes in the exception for the caller to show
+	if (!file.isOpen()) {
+		throw std::invalid_argument("Can't open texture " + filename +
+		                            ", usually because the PPM file is in another folder or the relative path is wrong");
 	}
-	inputStream.close();
+	std::string problem = decodePPM(file.data(), file.data() + file.size(), *this);
+	if (!problem.empty()) throw std::invalid_argument("Can't read texture " + filename + ", " + problem);
 }
 
 std::ostream &operator<<(std::ostream &os, const TextureMap &map) {
@@ -6,13 +6,16 @@
 #include "Utils.h"
 #include <cstdint>
 
+// An image as 0xAARRGGBB pixels, row by row from the top left
 class TextureMap {
 public:
-	size_t width;
-	size_t height;
+	size_t width{};
+	size_t height{};
 	std::vector<uint32_t> pixels;
 
 	TextureMap();
+	// Decodes a binary (P6) PPM file straight out of a memory map, converting many pixels at a time where there is SSSE3
+	// Throws std::invalid_argument if the file can't be opened or isn't a PPM with one byte per channel
 	TextureMap(const std::string &filename);
 	friend std::ostream &operator<<(std::ostream &os, const TextureMap &point);
 };
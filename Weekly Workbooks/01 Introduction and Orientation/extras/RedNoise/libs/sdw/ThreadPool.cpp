@@ -0,0 +1,71 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t threadCount) {
+	if (threadCount == 0) threadCount = 1;
+	// The caller of parallelFor is the last worker, so only spawn the extra ones
+	for (size_t i = 1; i < threadCount; i++) workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wakeWorkers.notify_all();
+	for (std::thread &worker : workers) worker.join();
+}
+
+size_t ThreadPool::size() const {
+	return workers.size() + 1;
+}
+
+void ThreadPool::runTasks(const std::function<void(size_t)> &task, size_t count) {
+	size_t i;
+	while ((i = nextIndex.fetch_add(1)) < count) task(i);
+}
+
+void ThreadPool::workerLoop() {
+	size_t seenGeneration = 0;
+	while (true) {
+		const std::function<void(size_t)> *task;
+		size_t count;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeWorkers.wait(lock, [&] { return stopping || generation != seenGeneration; });
+			if (stopping) return;
+			seenGeneration = generation;
+			// The job may already have been finished off by the other threads
+			if (currentTask == nullptr) continue;
+			task = currentTask;
+			count = taskCount;
+			busyWorkers++;
+		}
+		runTasks(*task, count);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			busyWorkers--;
+		}
+		jobFinished.notify_one();
+	}
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &task) {
+	if (count == 0) return;
+	if (workers.empty() || count == 1) {
+		for (size_t i = 0; i < count; i++) task(i);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		currentTask = &task;
+		taskCount = count;
+		nextIndex = 0;
+		generation++;
+	}
+	wakeWorkers.notify_all();
+	runTasks(task, count);
+	// Every index has been handed out, wait for workers still finishing theirs
+	std::unique_lock<std::mutex> lock(mutex);
+	jobFinished.wait(lock, [&] { return busyWorkers == 0 && nextIndex >= count; });
+	currentTask = nullptr;
+}
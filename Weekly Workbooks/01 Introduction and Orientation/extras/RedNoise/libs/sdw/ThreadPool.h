@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads that share out the iterations of a parallelFor between them
+class ThreadPool {
+public:
+	explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+	~ThreadPool();
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	size_t size() const;
+	// Calls task(i) for every i in [0, count) and returns once all of them have finished
+	// The calling thread also picks up work, so a pool of size 1 runs everything serially
+	void parallelFor(size_t count, const std::function<void(size_t)> &task);
+
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wakeWorkers;
+	std::condition_variable jobFinished;
+	const std::function<void(size_t)> *currentTask = nullptr;
+	size_t taskCount = 0;
+	std::atomic<size_t> nextIndex{0};
+	size_t busyWorkers = 0;
+	size_t generation = 0;
+	bool stopping = false;
+
+	void workerLoop();
+	void runTasks(const std::function<void(size_t)> &task, size_t count);
+};
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <array>
+#include "TileRenderer.h"
+#include "DepthPyramid.h"
+
+constexpr int TileRenderer::TILE_SIZE;
+constexpr int TileRenderer::TILE_LEVEL;
+static_assert((DepthPyramid::CELL_SIZE << TileRenderer::TILE_LEVEL) == TileRenderer::TILE_SIZE, "tiles must line up with a pyramid level");
+
+TileRenderer::TileRenderer(size_t w, size_t h, ThreadPool &threadPool) :
+		width(w),
+		height(h),
+		tilesX((w + TILE_SIZE - 1) / TILE_SIZE),
+		tilesY((h + TILE_SIZE - 1) / TILE_SIZE),
+		pool(threadPool),
+		bins(tilesX * tilesY) {}
+
+void TileRenderer::resize(size_t w, size_t h) {
+	if (w == width && h == height) return;
+	width = w;
+	height = h;
+	tilesX = (w + TILE_SIZE - 1) / TILE_SIZE;
+	tilesY = (h + TILE_SIZE - 1) / TILE_SIZE;
+	bins.assign(tilesX * tilesY, std::vector<uint32_t>());
+}
+
+PixelRect TileRenderer::tileRect(int tileIndex) const {
+	int left = (tileIndex % tilesX) * TILE_SIZE;
+	int top = (tileIndex / tilesX) * TILE_SIZE;
+	int right = std::min(left + TILE_SIZE, int(width)) - 1;
+	int bottom = std::min(top + TILE_SIZE, int(height)) - 1;
+	return PixelRect(left, top, right, bottom);
+}
+
+// The pyramid is only read here, before any tile starts changing it, so what it says about
+// the depth buffer is out of date but still safe to skip on (stored depths only ever get closer)
+void TileRenderer::binTriangles(const std::vector<CanvasTriangle> &triangles, const DepthPyramid *pyramid) {
+	for (std::vector<uint32_t> &bin : bins) bin.clear();
+	PixelRect screen(0, 0, int(width) - 1, int(height) - 1);
+	for (size_t i = 0; i < triangles.size(); i++) {
+		PixelRect area = triangleBounds(triangles[i]).intersect(screen);
+		if (area.isEmpty()) continue;
+		float nearest = nearestDepth(triangles[i]);
+		if (pyramid != nullptr && pyramid->isOccluded(area, nearest)) continue;
+		for (int ty = area.minY / TILE_SIZE; ty <= area.maxY / TILE_SIZE; ty++) {
+			for (int tx = area.minX / TILE_SIZE; tx <= area.maxX / TILE_SIZE; tx++) {
+				int tileIndex = ty * tilesX + tx;
+				if (pyramid != nullptr && pyramid->isOccluded(area.intersect(tileRect(tileIndex)), nearest, TILE_LEVEL)) continue;
+				bins[tileIndex].push_back(i);
+			}
+		}
+	}
+}
+
+void TileRenderer::renderTile(int tileIndex, const RasterBuffer &target, const std::vector<CanvasTriangle> &triangles,
+                              const std::vector<uint32_t> &colours, RasterStats *stats) const {
+	PixelRect rect = tileRect(tileIndex);
+	std::array<float, TILE_SIZE * TILE_SIZE> tileDepth;
+	std::array<uint32_t, TILE_SIZE * TILE_SIZE> tileColour;
+	size_t rowLength = rect.maxX - rect.minX + 1;
+
+	for (int y = rect.minY; y <= rect.maxY; y++) {
+		size_t source = (y - target.originY) * target.stride + (rect.minX - target.originX);
+		size_t tileRow = (y - rect.minY) * TILE_SIZE;
+		std::copy_n(target.depth + source, rowLength, tileDepth.begin() + tileRow);
+		std::copy_n(target.colour + source, rowLength, tileColour.begin() + tileRow);
+	}
+
+	// Each tile only touches the level 0 pyramid cells inside it, so the tiles can share the pyramid
+	RasterBuffer tile(tileColour.data(), tileDepth.data(), TILE_SIZE, rect.minX, rect.minY, target.depthPyramid);
+	tile.stats = stats;
+	for (uint32_t triangleIndex : bins[tileIndex]) {
+		fillTriangle(triangles[triangleIndex], rect, colours[triangleIndex], tile);
+	}
+
+	// Tiles never overlap, so writing back from several threads at once is safe
+	for (int y = rect.minY; y <= rect.maxY; y++) {
+		size_t destination = (y - target.originY) * target.stride + (rect.minX - target.originX);
+		size_t tileRow = (y - rect.minY) * TILE_SIZE;
+		std::copy_n(tileDepth.begin() + tileRow, rowLength, target.depth + destination);
+		std::copy_n(tileColour.begin() + tileRow, rowLength, target.colour + destination);
+	}
+}
+
+void TileRenderer::render(const RasterBuffer &target, const std::vector<CanvasTriangle> &triangles, const std::vector<uint32_t> &colours) {
+	binTriangles(triangles, target.depthPyramid);
+	std::vector<int> busyTiles;
+	for (size_t i = 0; i < bins.size(); i++) {
+		if (!bins[i].empty()) busyTiles.push_back(i);
+	}
+	// Each tile counts its own totals, the per-pixel counts are shared since tiles never overlap
+	std::vector<RasterStats> tileStats;
+	if (target.stats != nullptr) {
+		RasterStats tileStart = *target.stats;
+		tileStart.pixelsTested = 0;
+		tileStart.pixelsWritten = 0;
+		tileStats.assign(busyTiles.size(), tileStart);
+	}
+	pool.parallelFor(busyTiles.size(), [&](size_t i) {
+		renderTile(busyTiles[i], target, triangles, colours, tileStats.empty() ? nullptr : &tileStats[i]);
+	});
+	for (const RasterStats &stats : tileStats) target.stats->add(stats);
+	if (target.depthPyramid != nullptr) target.depthPyramid->propagate(PixelRect(0, 0, int(width) - 1, int(height) - 1));
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "CanvasTriangle.h"
+#include "Rasteriser.h"
+#include "ThreadPool.h"
+
+// Sorts projected triangles into screen tiles and then rasterises the tiles in parallel
+// Each tile works on its own colour/depth copy and processes its triangles in submission order,
+// so the result is bit-identical to filling the triangles one after another
+// If the target has a depth pyramid, triangles are left out of the tiles where they are already hidden
+// If it has stats, each tile counts into its own and they are added to the target's at the end
+class TileRenderer {
+public:
+	static constexpr int TILE_SIZE = 32;
+	// The depth pyramid level whose cells are exactly one tile
+	static constexpr int TILE_LEVEL = 2;
+
+	TileRenderer(size_t w, size_t h, ThreadPool &threadPool);
+	// Does nothing if the screen is already w * h
+	void resize(size_t w, size_t h);
+	// target covers the whole width * height screen, larger depths are closer to the camera
+	void render(const RasterBuffer &target, const std::vector<CanvasTriangle> &triangles, const std::vector<uint32_t> &colours);
+
+private:
+	size_t width;
+	size_t height;
+	int tilesX;
+	int tilesY;
+	ThreadPool &pool;
+	std::vector<std::vector<uint32_t>> bins;
+
+	PixelRect tileRect(int tileIndex) const;
+	void binTriangles(const std::vector<CanvasTriangle> &triangles, const DepthPyramid *pyramid);
+	void renderTile(int tileIndex, const RasterBuffer &target, const std::vector<CanvasTriangle> &triangles,
+	                const std::vector<uint32_t> &colours, RasterStats *stats) const;
+};
@@ -3,15 +3,16 @@
 #include "Utils.h"
 
 std::vector<std::string> split(const std::string &line, char delimiter) {
-	auto haystack = line;
 	std::vector<std::string> tokens;
+	// Walk along the line rather than erasing from the front of a copy, which made long lines quadratic
+	size_t start = 0;
 	size_t pos;
-	while ((pos = haystack.find(delimiter)) != std::string::npos) {
-		tokens.push_back(haystack.substr(0, pos));
-		haystack.erase(0, pos + 1);
+	while ((pos = line.find(delimiter, start)) != std::string::npos) {
+		tokens.push_back(line.substr(start, pos - start));
+		start = pos + 1;
 	}
 	// Push the remaining chars onto the vector
-	tokens.push_back(haystack);
+	tokens.push_back(line.substr(start));
 	return tokens;
 }
 
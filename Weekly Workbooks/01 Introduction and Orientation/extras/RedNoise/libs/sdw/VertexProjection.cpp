@@ -0,0 +1,156 @@
+#include "VertexProjection.h"
+
+#if !defined(SDW_SCALAR_RASTER) && defined(__AVX2__)
+#include <immintrin.h>
+#define PROJECT_AVX2
+#elif !defined(SDW_SCALAR_RASTER) && defined(__SSE2__)
+#include <emmintrin.h>
+#define PROJECT_SSE2
+#endif
+
+size_t VertexBuffer::size() const {
+	return x.size();
+}
+
+void VertexBuffer::clear() {
+	x.clear();
+	y.clear();
+	z.clear();
+}
+
+void VertexBuffer::reserve(size_t count) {
+	x.reserve(count);
+	y.reserve(count);
+	z.reserve(count);
+}
+
+void VertexBuffer::push_back(const glm::vec3 &position) {
+	x.push_back(position.x);
+	y.push_back(position.y);
+	z.push_back(position.z);
+}
+
+glm::vec3 VertexBuffer::operator[](size_t i) const {
+	return glm::vec3(x[i], y[i], z[i]);
+}
+
+VertexView::VertexView(const float *x, const float *y, const float *z, size_t count) : x(x), y(y), z(z), count(count) {}
+
+VertexView::VertexView(const VertexBuffer &buffer) : x(buffer.x.data()), y(buffer.y.data()), z(buffer.z.data()), count(buffer.size()) {}
+
+size_t VertexView::size() const {
+	return count;
+}
+
+glm::vec3 VertexView::operator[](size_t i) const {
+	return glm::vec3(x[i], y[i], z[i]);
+}
+
+size_t ProjectedVertices::size() const {
+	return x.size();
+}
+
+void ProjectedVertices::resize(size_t count) {
+	x.resize(count);
+	y.resize(count);
+	depth.resize(count);
+}
+
+CanvasPoint ProjectedVertices::point(size_t i) const {
+	return CanvasPoint(x[i], y[i], depth[i]);
+}
+
+glm::mat4 viewProjectionMatrix(const glm::vec3 &cameraPosition, const glm::mat3 &cameraOrientation, float focalLength, float imageScale,
+                               int width, int height) {
+	// World to camera space: undo the camera's position, then its rotation
+	glm::mat3 toCamera = glm::transpose(cameraOrientation);
+	glm::mat4 view(toCamera);
+	view[3] = glm::vec4(-(toCamera * cameraPosition), 1.0f);
+
+	// The camera looks down -z, so w = -z, and x * w and y * w pick up the offset to the middle of the screen
+	float pixelsPerUnit = imageScale * focalLength;
+	glm::mat4 projection(0.0f);
+	projection[0][0] = pixelsPerUnit;
+	projection[1][1] = -pixelsPerUnit;
+	projection[2][0] = -width / 2.0f;
+	projection[2][1] = -height / 2.0f;
+	projection[2][3] = -1.0f;
+	projection[3][2] = 1.0f;
+	return projection * view;
+}
+
+CanvasPoint projectVertex(const glm::mat4 &viewProjection, const glm::vec3 &position) {
+	glm::vec4 clip = viewProjection * glm::vec4(position, 1.0f);
+	float inverseW = 1.0f / clip.w;
+	return CanvasPoint(clip.x * inverseW, clip.y * inverseW, clip.z * inverseW);
+}
+
+// One row of the matrix applied to a vertex, in the same order as the vector code
+static inline float transformRow(const glm::mat4 &m, int row, float x, float y, float z) {
+	return ((m[0][row] * x + m[1][row] * y) + m[2][row] * z) + m[3][row];
+}
+
+static void projectScalar(const glm::mat4 &m, const VertexView &vertices, size_t first, size_t last, ProjectedVertices &out) {
+	for (size_t i = first; i < last; i++) {
+		float x = vertices.x[i];
+		float y = vertices.y[i];
+		float z = vertices.z[i];
+		float inverseW = 1.0f / transformRow(m, 3, x, y, z);
+		out.x[i] = transformRow(m, 0, x, y, z) * inverseW;
+		out.y[i] = transformRow(m, 1, x, y, z) * inverseW;
+		out.depth[i] = transformRow(m, 2, x, y, z) * inverseW;
+	}
+}
+
+#if defined(PROJECT_AVX2)
+static inline __m256 transformRow(const glm::mat4 &m, int row, __m256 x, __m256 y, __m256 z) {
+	__m256 sum = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m[0][row]), x), _mm256_mul_ps(_mm256_set1_ps(m[1][row]), y));
+	sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(m[2][row]), z));
+	return _mm256_add_ps(sum, _mm256_set1_ps(m[3][row]));
+}
+
+void projectVertices(const glm::mat4 &viewProjection, const VertexView &vertices, size_t first, size_t last, ProjectedVertices &out) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	size_t i = first;
+	for (; i + 8 <= last; i += 8) {
+		__m256 x = _mm256_loadu_ps(&vertices.x[i]);
+		__m256 y = _mm256_loadu_ps(&vertices.y[i]);
+		__m256 z = _mm256_loadu_ps(&vertices.z[i]);
+		__m256 inverseW = _mm256_div_ps(one, transformRow(viewProjection, 3, x, y, z));
+		_mm256_storeu_ps(&out.x[i], _mm256_mul_ps(transformRow(viewProjection, 0, x, y, z), inverseW));
+		_mm256_storeu_ps(&out.y[i], _mm256_mul_ps(transformRow(viewProjection, 1, x, y, z), inverseW));
+		_mm256_storeu_ps(&out.depth[i], _mm256_mul_ps(transformRow(viewProjection, 2, x, y, z), inverseW));
+	}
+	projectScalar(viewProjection, vertices, i, last, out);
+}
+#elif defined(PROJECT_SSE2)
+static inline __m128 transformRow(const glm::mat4 &m, int row, __m128 x, __m128 y, __m128 z) {
+	__m128 sum = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0][row]), x), _mm_mul_ps(_mm_set1_ps(m[1][row]), y));
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(m[2][row]), z));
+	return _mm_add_ps(sum, _mm_set1_ps(m[3][row]));
+}
+
+void projectVertices(const glm::mat4 &viewProjection, const VertexView &vertices, size_t first, size_t last, ProjectedVertices &out) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	size_t i = first;
+	for (; i + 4 <= last; i += 4) {
+		__m128 x = _mm_loadu_ps(&vertices.x[i]);
+		__m128 y = _mm_loadu_ps(&vertices.y[i]);
+		__m128 z = _mm_loadu_ps(&vertices.z[i]);
+		__m128 inverseW = _mm_div_ps(one, transformRow(viewProjection, 3, x, y, z));
+		_mm_storeu_ps(&out.x[i], _mm_mul_ps(transformRow(viewProjection, 0, x, y, z), inverseW));
+		_mm_storeu_ps(&out.y[i], _mm_mul_ps(transformRow(viewProjection, 1, x, y, z), inverseW));
+		_mm_storeu_ps(&out.depth[i], _mm_mul_ps(transformRow(viewProjection, 2, x, y, z), inverseW));
+	}
+	projectScalar(viewProjection, vertices, i, last, out);
+}
+#else
+void projectVertices(const glm::mat4 &viewProjection, const VertexView &vertices, size_t first, size_t last, ProjectedVertices &out) {
+	projectScalar(viewProjection, vertices, first, last, out);
+}
+#endif
+
+void projectVertices(const glm::mat4 &viewProjection, const VertexView &vertices, ProjectedVertices &out) {
+	out.resize(vertices.size());
+	projectVertices(viewProjection, vertices, 0, vertices.size(), out);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "CanvasPoint.h"
+
+// Vertex positions stored as separate x, y and z arrays, so a batch of them can be loaded straight into vector registers
+// Indexing gives back a glm::vec3 (by value), so it reads like a std::vector<glm::vec3>
+struct VertexBuffer {
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+
+	size_t size() const;
+	void clear();
+	void reserve(size_t count);
+	void push_back(const glm::vec3 &position);
+	glm::vec3 operator[](size_t i) const;
+};
+
+// Read-only x, y and z arrays of vertices that are stored somewhere else, a VertexBuffer or a mapped SceneBundle,
+// so the projection and culling stages can work on either without copying them
+struct VertexView {
+	const float *x{};
+	const float *y{};
+	const float *z{};
+	size_t count{};
+
+	VertexView() = default;
+	VertexView(const float *x, const float *y, const float *z, size_t count);
+	VertexView(const VertexBuffer &buffer);
+	size_t size() const;
+	glm::vec3 operator[](size_t i) const;
+};
+
+// Screen positions written by projectVertices, one entry per vertex of the buffer that was projected
+struct ProjectedVertices {
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> depth;
+
+	size_t size() const;
+	void resize(size_t count);
+	CanvasPoint point(size_t i) const;
+};
+
+// The matrix that takes a world position (x, y, z, 1) to (u * w, v * w, 1, w) for the pinhole camera
+//   u = -imageScale * focalLength * x / z + width / 2
+//   v =  imageScale * focalLength * y / z + height / 2
+// with x, y, z measured from the camera in its own frame, as in projectVertexOntoCanvasPoint
+// Dividing by w gives the screen position and depth = 1/w, the same 1/z depth the rasteriser uses
+// The columns of cameraOrientation are the camera's right, up and backward (away from the view) directions in world space
+glm::mat4 viewProjectionMatrix(const glm::vec3 &cameraPosition, const glm::mat3 &cameraOrientation, float focalLength, float imageScale,
+                               int width, int height);
+
+// Projects one vertex, the reference for projectVertices
+CanvasPoint projectVertex(const glm::mat4 &viewProjection, const glm::vec3 &position);
+
+// Projects vertices [first, last) of the buffer into the same entries of out, which must already be big enough
+// Works on 8 (AVX2) or 4 (SSE2) vertices at a time, like fillTriangle, and ranges are independent so callers can split a
+// big buffer across threads
+// Vertices at or behind the camera (w <= 0) come out as garbage, the culling stage has to keep them away from the rasteriser
+void projectVertices(const glm::mat4 &viewProjection, const VertexView &vertices, size_t first, size_t last, ProjectedVertices &out);
+void projectVertices(const glm::mat4 &viewProjection, const VertexView &vertices, ProjectedVertices &out);
@@ -1,362 +1,210 @@
 #include <iostream>
-#include <fstream>
+#include <memory>
 #include <string>
+#include <DrawingThread.h>
 #include <DrawingWindow.h>
-#include <ModelTriangle.h>
+#include <FrameProfiler.h>
+#include <FrameScheduler.h>
 #include <vector>
-#include <map>
-#include <Utils.h>
-#include <CanvasPoint.h>
-#include <CanvasTriangle.h>
-#include <Colour.h>
 #include <TextureMap.h>
+#include <RenderTarget.h>
+#include <SceneBundle.h>
+#include <TextureCache.h>
+#include <IndexedMesh.h>
 #include <glm/glm.hpp>
+#include "ModellingPipeline.h"
 
+//default resolution, "3DModelling <width> <height>" renders at any other size
 #define WIDTH 320
 #define HEIGHT 240
+//where the Cornell box that is drawn by default lives, the build points this at src
+#ifndef SCENE_DIR
+#define SCENE_DIR "src"
+#endif
 
-//create 2d array with demensions widthxheight
-float depthBuffer[WIDTH][HEIGHT];
+using namespace modelling;
 
-//initialise all values to 0
-void initializeDepthBuffer(){
-
-    for (int i = 0; i < WIDTH; i++)
-    {
-        for (int j = 0; j < HEIGHT; j++)
-        {
-            depthBuffer[i][j] = 0.0;
-        }
-    }
-}
-
-// return a vector of ModelTriangles from an .obj file
-std::vector<ModelTriangle> processOBJFile(const std::string &filename, const std::map<std::string, Colour> &colourMap){
-
-    std::ifstream inputFile(filename);
-    if (!inputFile.is_open())
-    {
-        std::cerr << "Error opening file!" << std::endl;
-        return {};
-    }
-
-    std::vector<ModelTriangle> triangles;
-    std::vector<glm::vec3> verticesList;
-    std::vector<glm::vec3> faceVertices;
-    std::vector<std::string> colours;
-    std::string colourName;
-
-    std::string line;
-    while (std::getline(inputFile, line))
-    {
-        char c = line[0];
-        char delimiter = ' ';
-
-        if (c == 'u')
-        {
-             // usemtl for colour
-            std::vector<std::string> linesplit = split(line, delimiter);
-            colourName = linesplit[1];
-            //colours.push_back(colourName);
-
-        }
-        else if (c == 'v'){
-
-            glm::vec3 vertices;
-            // split line by delimiter
-            std::vector<std::string> linesplit = split(line, delimiter);
-
-            // add the three vertices to the glm::vec3
-            vertices.x = 0.35*std::stof(linesplit[1]);
-            vertices.y = 0.35*std::stof(linesplit[2]);
-            vertices.z = 0.35*std::stof(linesplit[3]);
-            verticesList.push_back(vertices);
-            // v for vertices
-            // loop through each line, check first letter of each line to see if v or f
-        }
-        else if (c == 'f'){
-
-            // split line by delimiter
-            std::vector<std::string> linesplit = split(line, delimiter);
-
-            glm::vec3 face;
-            face.x = std::stof(linesplit[1].substr(0, linesplit[1].find('/')));
-            face.y = std::stof(linesplit[2].substr(0, linesplit[2].find('/')));
-            face.z = std::stof(linesplit[3].substr(0, linesplit[3].find('/')));
-
-            faceVertices.push_back(face);
-            colours.push_back(colourName);
-        }
-    }
-    // loop face vertices and make triangles
-    inputFile.close();
+void handleEvent(SDL_Event event, DrawingWindow &window)
+{
 
-    for (int i = 0; i < faceVertices.size(); i++)
+    if (event.type == SDL_KEYDOWN)
     {
-        ModelTriangle triangle(
-            verticesList[(faceVertices[i].x) - 1],
-            verticesList[(faceVertices[i].y) - 1],
-            verticesList[(faceVertices[i].z) - 1],
-            //get colour from the hashmap
-            colourMap.at(colours[i])
-        );
-        triangles.push_back(triangle);
-    }
-    return triangles;
-}
-
-// returns a hashmap of colours from a .mtl file
-std::map<std::string, Colour> loadPalette(const std::string &filename){
+        if (event.key.keysym.sym == SDLK_LEFT)
+            std::cout << "LEFT" << std::endl;
+        else if (event.key.keysym.sym == SDLK_RIGHT)
+            std::cout << "RIGHT" << std::endl;
+        else if (event.key.keysym.sym == SDLK_UP)
+            std::cout << "UP" << std::endl;
+        else if (event.key.keysym.sym == SDLK_DOWN)
+            std::cout << "DOWN" << std::endl;
+        else if (event.key.keysym.sym == SDLK_p)
+            profiler.setEnabled(!profiler.isEnabled());
+        else if (event.key.keysym.sym == SDLK_o)
+            renderMode = RenderMode((renderMode + 1) % RENDER_MODE_COUNT);
 
-    std::ifstream inputFile(filename);
-    if (!inputFile.is_open())
-    {
-        std::cerr << "Error opening palette file!" << std::endl;
-        return {};
+        else if (event.key.keysym.sym == SDLK_ESCAPE)
+            window.exitCleanly();
     }
-
-    std::map<std::string, Colour> colours;
-    std::string line;
-
-    while (std::getline(inputFile, line))
+    else if (event.type == SDL_MOUSEBUTTONDOWN)
     {
-        char delimiter = ' ';
-        char c = line[0];
-        Colour colour;
-        if (c == 'n')
-        {
-            std::vector<std::string> linesplit = split(line, delimiter);
-            colour.name = linesplit[1];
-
-            getline(inputFile, line); // skip Kd line for now
-            linesplit = split(line, delimiter);
-            std::string name = linesplit[0];
-            colour.red = std::stof(linesplit[1]) * 255;
-            colour.green = std::stof(linesplit[2]) * 255;
-            colour.blue = std::stof(linesplit[3]) * 255;
-            colours[colour.name] = colour;
-        }
+        window.savePPM("output.ppm");
+        window.saveBMP("output.bmp");
     }
-    inputFile.close();
-
-    return colours;
 }
 
-std::vector<CanvasPoint> interpolate2Coords(CanvasPoint p1, CanvasPoint p2){
-
-	std::vector<CanvasPoint> pointsBetween;
-	float x_dist = p2.x - p1.x;
-	float y_dist = p2.y - p1.y;
-    float depth_dist = p2.depth - p1.depth;
-
-	float numberOfSteps = fmax(abs(x_dist), abs(y_dist));
-	float x_spacing = x_dist / numberOfSteps;
-	float y_spacing = y_dist / numberOfSteps;
-    float depth_spacing = depth_dist / numberOfSteps;
-
-	for (int i = 0; i <= numberOfSteps; i++)
-	{
-		float x = p1.x + (x_spacing * i);
-		float y = p1.y + (y_spacing * i);
-        float depth = p1.depth + (depth_spacing * i);
-
-        //std::cout << "Depth at step " << i << ": " << depth << std::endl;
-		pointsBetween.push_back(CanvasPoint(x, y, depth));
-	}
-	return pointsBetween;
+//whether a command line argument names a file of this kind
+bool hasExtension(const std::string &path, const std::string &extension){
+    return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
 }
 
-void drawLine(DrawingWindow &window, CanvasPoint from, CanvasPoint to, Colour colour_param){
-
-    uint32_t colour = (255 << 24) + (int(colour_param.red) << 16) + (int(colour_param.green) << 8) + int(colour_param.blue);
-    if (from.x == to.x && from.y == to.y)
-    {
-        window.setPixelColour(from.x, from.y, colour);
-        return;
-    }
-    //std::cout << "From depth: " << from.depth << ", To depth: " << to.depth << std::endl;
-    std::vector<CanvasPoint> pointsBetween = interpolate2Coords(from, to);
-    for (int i = 0; i < pointsBetween.size(); i++){
-        //check if depth is greater than current depth buffer value
-        if (pointsBetween[i].depth > depthBuffer[int((pointsBetween[i].y))][int((pointsBetween[i].x))] ) {
-            //update depth buffer
-            depthBuffer[int((pointsBetween[i].y))][int((pointsBetween[i].x))]= pointsBetween[i].depth;
-        } else {
-            continue; //skip drawing this pixel
-        }
-        window.setPixelColour((pointsBetween[i].x), (pointsBetween[i].y), colour);
-    }
+//reads a width or height, false unless the whole argument is a positive whole number
+bool parseSize(const std::string &arg, int &size){
+    //nine digits can't overflow an int
+    if (arg.empty() || arg.size() > 9 || arg.find_first_not_of("0123456789") != std::string::npos) return false;
+    size = std::stoi(arg);
+    return size > 0;
 }
 
-
-void strokedTriangle(DrawingWindow &window, CanvasTriangle triangle, Colour colour){
-
-    drawLine(window, triangle.v0(), triangle.v1(), colour);
-    drawLine(window, triangle.v1(), triangle.v2(), colour);
-    drawLine(window, triangle.v2(), triangle.v0(), colour);
+//the two ways of running it, for when the command line doesn't make sense
+int printUsage(){
+    std::cerr << "usage: 3DModelling [width height] [model.obj palette.mtl | scene.bundle] [--headless]" << std::endl
+              << "       3DModelling --convert scene.bundle [model.obj palette.mtl] [texture.ppm]" << std::endl;
+    return 1;
 }
 
-
-// returns the 2D CanvasPoint postion at which the model vertex should be projected onto the image plane
-CanvasPoint projectVertexOntoCanvasPoint(glm::vec3 cameraPostion, float focalLength, glm::vec3 vertexPosition, DrawingWindow &window){
-
-    CanvasPoint pointOnImage;
-    glm::vec3 relativePosition = cameraPostion - vertexPosition;
-    float scale = 160.0f;
-
-    // u = - f * (x/z) + W/2
-    // v =   f * (y/z) + H/2
-    pointOnImage.x = scale * (focalLength * (-relativePosition.x / relativePosition.z))  + WIDTH / 2;
-    pointOnImage.y = scale * (focalLength * (relativePosition.y / relativePosition.z)) + HEIGHT / 2;
-    pointOnImage.depth = 1/(relativePosition.z);
-
-    return pointOnImage;
-}
-
-void renderPointCloud(DrawingWindow &window, const std::vector<ModelTriangle> triangles, glm::vec3 cameraPos, float focalLength)
-{
-    for (int i = 0; i < triangles.size(); i++)
+int main(int argc, char *argv[]){
+    // 3DModelling [width height] [model.obj palette.mtl | scene.bundle] [--headless]
+    //headless renders one frame into output.ppm without opening a window, without a scene the Cornell box in src is drawn
+    // 3DModelling --convert scene.bundle [model.obj palette.mtl] [texture.ppm]
+    //saves the scene (and texture) as a bundle that later runs map straight into memory instead of parsing, then exits
+    //exits with 1 if anything it was asked to load or save couldn't be, or after printing the usage for anything it doesn't understand
+    bool headless = false;
+    std::string convertTo, objPath = SCENE_DIR "/cornell-box.obj", mtlPath = SCENE_DIR "/cornell-box.mtl", bundlePath, texturePath;
+    std::vector<int> size;
+    for (int i = 1; i < argc; i++)
     {
-        // Project the 3D vertices onto the 2D canvas
-        for (int j = 0; j < 3; j++)
+        std::string arg = argv[i];
+        if (arg == "--headless") headless = true;
+        else if (arg == "--convert")
+        {
+            if (i + 1 == argc || argv[i + 1][0] == '-') return printUsage();
+            convertTo = argv[++i];
+        }
+        else if (hasExtension(arg, ".obj")) objPath = arg;
+        else if (hasExtension(arg, ".mtl")) mtlPath = arg;
+        else if (hasExtension(arg, ".ppm")) texturePath = arg;
+        else if (hasExtension(arg, ".bundle")) bundlePath = arg;
+        else
         {
-            CanvasPoint point = projectVertexOntoCanvasPoint(
-                cameraPos,                // Camera position
-                focalLength,              // Focal length
-                triangles[i].vertices[j], // Vertex position
-                window                    // Drawing window
-            );
-            // Draw the triangle on the canvas
-            uint32_t colour = (255 << 24) + (255 << 16) + (255 << 8) + int(255);
-            window.setPixelColour(point.x, point.y, colour);
+            int dimension;
+            if (!parseSize(arg, dimension)) return printUsage();
+            size.push_back(dimension);
         }
     }
-}
-
-void renderWireframe(DrawingWindow &window, const std::vector<ModelTriangle> triangles, glm::vec3 cameraPos, float focalLength){
-    std::vector<CanvasTriangle> projectedTriangles;
-    for (int i = 0; i < triangles.size(); i++)
+    //a size is a width and a height, both or neither
+    if (size.size() != 0 && size.size() != 2) return printUsage();
+    if (!convertTo.empty())
     {
-        // Project the 3D vertices onto the 2D canvas
-        CanvasPoint projectedVertices[3];
-        for (int j = 0; j < 3; j++)
+        IndexedMesh mesh;
+        if (!loadScene(objPath, mtlPath, mesh)) return 1;
+        std::shared_ptr<const TextureMap> texture;
+        try
         {
-            projectedVertices[j] = projectVertexOntoCanvasPoint(
-                cameraPos,                // Camera position
-                focalLength,              // Focal length
-                triangles[i].vertices[j], // Vertex position
-                window                    // Drawing window
-            );
+            if (!texturePath.empty()) texture = textureCache().get(texturePath);
         }
-
-        // Draw the triangle on the canvas
-        CanvasTriangle canvasTriangle(projectedVertices[0], projectedVertices[1], projectedVertices[2]);
-        //need to see which triangles have the greater depth to draw first
-
-
-        strokedTriangle(window, canvasTriangle, triangles[i].colour);
+        catch (const std::invalid_argument &problem)
+        {
+            std::cerr << "Error loading texture! (" << problem.what() << ")" << std::endl;
+            return 1;
+        }
+        std::string error;
+        if (!writeSceneBundle(convertTo, mesh, texture.get(), error))
+        {
+            std::cerr << "Error writing bundle! (" << error << ")" << std::endl;
+            return 1;
+        }
+        std::cout << "Saved " << mesh.triangleCount() << " triangles to " << convertTo << std::endl;
+        return 0;
     }
-}
-
-void barycentricFillTriangle(DrawingWindow &window, CanvasTriangle triangle, Colour colour_param){
-	CanvasPoint v0 = triangle.v0();
-	CanvasPoint v1 = triangle.v1();
-	CanvasPoint v2 = triangle.v2();
-    //check that the triangle is within the window bounds
-
-	glm::vec2 v0_vec2 (v0.x, v0.y);
-	glm::vec2 v1_vec2 (v1.x, v1.y);
-	glm::vec2 v2_vec2 (v2.x, v2.y);
-	uint32_t colour = (255 << 24) + (int(colour_param.red) << 16) + (int(colour_param.green) << 8) + int(colour_param.blue);
-
-	const int minX = std::min(std::min(v0.x, v1.x), v2.x);
-	const int maxX = std::max(std::max(v0.x, v1.x), v2.x);
-	const int minY = std::min(std::min(v0.y, v1.y), v2.y);
-	const int maxY = std::max(std::max(v0.y, v1.y), v2.y);
-
-
-	for (int y = minY; y <= maxY; y++)
-	{
-
-		for (int x = minX; x <= maxX; x++)
-		{
-           glm::vec3 coords = convertToBarycentricCoordinates(v0_vec2, v1_vec2, v2_vec2, glm::vec2(x, y));
-
-            if (coords.x >= 0 && coords.y >= 0 && coords.z >= 0)
-			{
-                float depth = ((coords.x * v1.depth) + (coords.y * v2.depth) + (coords.z * v0.depth));
-                if (y >=0 && y < HEIGHT && x >=0 && x < WIDTH && depth > depthBuffer[y][x])
-                {
-                    depthBuffer[y][x] = depth;
-                    window.setPixelColour(x, y, colour);
-                }
-			}
-		}
-	}
-}
-
-void rasterisedRender(DrawingWindow &window, const std::vector<ModelTriangle> triangles, glm::vec3 cameraPos, float focalLength){
-    for (int i = 0; i < triangles.size(); i++)
+    int width = size.empty() ? WIDTH : size[0];
+    int height = size.empty() ? HEIGHT : size[1];
+    DrawingWindow window = headless ? DrawingWindow::offscreen(width, height) : DrawingWindow(width, height, false);
+    RenderTarget target(width, height);
+    FrameScheduler scheduler(window);
+    std::vector<SDL_Event> events;
+    glm::vec3 cameraPos = glm::vec3(0.0, 0.0, 4.0);
+    float focalLength = 2.0;
+    //a bundle is drawn from where it is mapped, an .obj is parsed into a mesh first
+    IndexedMesh loadedMesh;
+    std::unique_ptr<SceneBundle> bundle;
+    MeshView OBJContents;
+    if (!bundlePath.empty())
     {
-        // Project the 3D vertices onto the 2D canvas
-        CanvasPoint projectedVertices[3];
-        for (int j = 0; j < 3; j++)
+        bundle.reset(new SceneBundle(bundlePath));
+        if (!bundle->isOpen())
         {
-            projectedVertices[j] = projectVertexOntoCanvasPoint(
-                cameraPos,                // Camera position
-                focalLength,              // Focal length
-                triangles[i].vertices[j], // Vertex position
-                window                    // Drawing window
-            );
+            std::cerr << "Error opening bundle! (" << bundle->error() << ")" << std::endl;
+            return 1;
         }
-        // Draw the triangle on the canvas
-        CanvasTriangle canvasTriangle(projectedVertices[0], projectedVertices[1], projectedVertices[2]);
-        std::cout << "Rasterising triangle " << i << std::endl;
-        barycentricFillTriangle(window, canvasTriangle, triangles[i].colour);
-}
-}
-
-void handleEvent(SDL_Event event, DrawingWindow &window)
-{
-
-    if (event.type == SDL_KEYDOWN)
+        OBJContents = bundle->mesh();
+    }
+    else
     {
-        if (event.key.keysym.sym == SDLK_LEFT)
-            std::cout << "LEFT" << std::endl;
-        else if (event.key.keysym.sym == SDLK_RIGHT)
-            std::cout << "RIGHT" << std::endl;
-        else if (event.key.keysym.sym == SDLK_UP)
-            std::cout << "UP" << std::endl;
-        else if (event.key.keysym.sym == SDLK_DOWN)
-            std::cout << "DOWN" << std::endl;
-
-        else if (event.key.keysym.sym == SDLK_ESCAPE)
-            window.exitCleanly();
+        if (!loadScene(objPath, mtlPath, loadedMesh)) return 1;
+        OBJContents = loadedMesh;
     }
-    else if (event.type == SDL_MOUSEBUTTONDOWN)
+    drawFrame(window, target, OBJContents, cameraPos, focalLength);
+    std::cout << "Culled " << cullStats.culled() << " of " << cullStats.submitted << " triangles ("
+              << cullStats.backFacing << " back-facing, " << cullStats.outsideFrustum << " outside the view), clipped "
+              << cullStats.clipped << " into " << cullStats.clippedPieces << ", projected "
+              << projectedVertices.size() << " vertices" << std::endl;
+    if (headless)
     {
         window.savePPM("output.ppm");
-        window.saveBMP("output.bmp");
+        return 0;
     }
-}
-
-int main(int argc, char *argv[]){
-    DrawingWindow window = DrawingWindow(WIDTH, HEIGHT, false);
-    SDL_Event event;
-    glm::vec3 cameraPos = glm::vec3(0.0, 0.0, 4.0);
-    float focalLength = 2.0;
-    initializeDepthBuffer();
-    std::map<std::string, Colour> colourMap = loadPalette("/home/leonie/CG2025/Weekly Workbooks/01 Introduction and Orientation/extras/RedNoise/src/cornell-box.mtl");
-    std::vector<ModelTriangle> OBJContents = processOBJFile("/home/leonie/CG2025/Weekly Workbooks/01 Introduction and Orientation/extras/RedNoise/src/cornell-box.obj", colourMap);
-    //renderPointCloud(window, OBJContents, cameraPos, focalLength);
-    //renderWireframe(window, OBJContents, cameraPos, focalLength);
-    rasterisedRender(window, OBJContents, cameraPos, focalLength);
+    //every frame after the first is drawn on this thread, and queued for the main thread to present
+    DrawingThread drawer([&] {
+        drawFrame(window, target, OBJContents, cameraPos, focalLength);
+        window.queueFrame();
+    });
     while (true)
     {
-        // We MUST poll for events - otherwise the window will freeze !
-        if (window.pollForInputEvents(event))
+        // Sleeps until there is input or a changed frame is due, rather than spinning on the CPU
+        // and handles everything that arrived since the last frame before drawing the next one
+        bool wasProfiling = profiler.isEnabled();
+        RenderMode previousMode = renderMode;
+        scheduler.waitForInputEvents(events);
+        for (const SDL_Event &event : events)
             handleEvent(event, window);
-        // Need to render the frame at the end, or nothing actually gets shown on the screen !
-        window.renderFrame();
+        if (wasProfiling && !profiler.isEnabled())
+        {
+            profiler.writeLog("profile.json");
+            profiler.writeLog("profile.csv");
+            std::cout << "Wrote " << profiler.frameCount() << " frames to profile.json and profile.csv" << std::endl;
+        }
+        // While profiling the scene is redrawn every frame so there is something to measure,
+        //otherwise only when what it shows has changed (a new mode, or the HUD going on or off)
+        bool redraw = (profiler.isEnabled() && scheduler.frameDue()) || profiler.isEnabled() != wasProfiling || renderMode != previousMode;
+        if (redraw)
+        {
+            //any frame still queued is uploaded and presented on this thread (SDL only renders on the one
+            //that made the window) while the drawing thread and the worker pool draw the next one behind it
+            profiler.beginFrame();
+            drawer.request();
+            FrameProfiler::Clock::time_point presentStart = FrameProfiler::Clock::now();
+            scheduler.presentQueued();
+            double presentTime = std::chrono::duration<double>(FrameProfiler::Clock::now() - presentStart).count();
+            //the next events can change what is drawn, and the window's pixels are saved on a click
+            drawer.wait();
+            //added once the drawing thread is done with the profiler's frame
+            profiler.addTime(FrameProfiler::PRESENT, presentTime);
+            profiler.endFrame();
+        }
+        else
+        {
+            // Only frames that have been drawn into or queued are presented, at most 60 times a second
+            scheduler.presentIfDirty();
+        }
     }
 }
\ No newline at end of file
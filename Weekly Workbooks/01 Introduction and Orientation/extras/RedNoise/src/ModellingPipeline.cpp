@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <OBJParser.h>
+#include <Utils.h>
+#include <Rasteriser.h>
+#include <TileRenderer.h>
+#include <VertexProjection.h>
+#include "ModellingPipeline.h"
+
+//pixels per unit of the image plane, and how close to the camera a point can be and still be drawn
+#define IMAGE_SCALE 160.0f
+#define NEAR_PLANE 0.01f
+
+namespace modelling {
+
+CullStats cullStats;
+ProjectedVertices projectedVertices;
+FrameProfiler profiler;
+RenderMode renderMode = SHADED;
+OverdrawMap overdrawMap;
+
+// one set of worker threads for loading and rendering
+ThreadPool &workerPool(){
+    static ThreadPool pool;
+    return pool;
+}
+
+// fill mesh from an .obj file, each "v" line becomes one vertex that the faces refer to
+//the file is memory-mapped and parsed in parallel chunks, see OBJParser.h
+//returns false, leaving mesh empty, if the file can't be opened or parsed
+bool processOBJFile(const std::string &filename, const MaterialTable &palette, IndexedMesh &mesh){
+
+    mesh = IndexedMesh();
+    OBJData obj;
+    if (!parseOBJFile(filename, obj, &workerPool()))
+    {
+        std::cerr << "Error opening file! (" << obj.error << ")" << std::endl;
+        return false;
+    }
+
+    mesh.vertices.reserve(obj.positions.size());
+    for (const glm::vec3 &position : obj.positions)
+        mesh.vertices.push_back(glm::vec3(0.35 * position.x, 0.35 * position.y, 0.35 * position.z));
+
+    //faces refer to the palette by number, each name is only looked up once
+    //a material the palette doesn't have is added to the mesh's copy of it as white
+    mesh.materialTable = palette;
+    std::vector<uint32_t> materials;
+    for (const std::string &name : obj.materialNames)
+    {
+        uint32_t material = palette.find(name);
+        if (material == MaterialTable::NOT_FOUND)
+        {
+            std::cerr << "No material called \"" << name << "\" in the palette, using white" << std::endl;
+            material = mesh.materialTable.add(Colour(name, 255, 255, 255));
+        }
+        materials.push_back(material);
+    }
+
+    mesh.reserve(obj.triangleCount());
+    for (size_t i = 0; i < obj.triangleCount(); i++)
+    {
+        //faces are wound counter-clockwise when seen from the front
+        mesh.addTriangle(obj.indices[3 * i], obj.indices[3 * i + 1], obj.indices[3 * i + 2], materials[obj.materials[i]]);
+    }
+    //corners that didn't give a texture coordinate in a file where others did get (0, 0)
+    mesh.textureCoordinates.reserve(obj.textureIndices.size());
+    for (uint32_t index : obj.textureIndices)
+        mesh.textureCoordinates.push_back(index == NO_TEXTURE_COORDINATE ? glm::vec2(0.0f) : obj.textureCoordinates[index]);
+    return true;
+}
+
+// fill colours with a table of the colours in a .mtl file, numbered in the order they are listed
+//returns false if the file can't be opened
+bool loadPalette(const std::string &filename, MaterialTable &colours){
+
+    colours = MaterialTable();
+    std::ifstream inputFile(filename);
+    if (!inputFile.is_open())
+    {
+        std::cerr << "Error opening palette file! (can't open " << filename << ")" << std::endl;
+        return false;
+    }
+
+    std::string line;
+
+    while (std::getline(inputFile, line))
+    {
+        char delimiter = ' ';
+        char c = line[0];
+        Colour colour;
+        if (c == 'n')
+        {
+            std::vector<std::string> linesplit = split(line, delimiter);
+            colour.name = linesplit[1];
+
+            getline(inputFile, line); // skip Kd line for now
+            linesplit = split(line, delimiter);
+            std::string name = linesplit[0];
+            colour.red = std::stof(linesplit[1]) * 255;
+            colour.green = std::stof(linesplit[2]) * 255;
+            colour.blue = std::stof(linesplit[3]) * 255;
+            colours.add(colour);
+        }
+    }
+    inputFile.close();
+
+    return true;
+}
+
+// the palette and then the mesh that uses it, false if either couldn't be loaded
+bool loadScene(const std::string &objPath, const std::string &mtlPath, IndexedMesh &mesh){
+    MaterialTable palette;
+    return loadPalette(mtlPath, palette) && processOBJFile(objPath, palette, mesh);
+}
+
+//drawLine doesn't update the depth pyramid, which only makes it skip less
+void drawLine(RenderTarget &target, CanvasPoint from, CanvasPoint to, Colour colour_param){
+
+    uint32_t colour = (255 << 24) + (int(colour_param.red) << 16) + (int(colour_param.green) << 8) + int(colour_param.blue);
+    rasteriseLine(from, to, target.bounds(), colour, target.buffer());
+}
+
+
+void strokedTriangle(RenderTarget &target, CanvasTriangle triangle, Colour colour){
+
+    drawLine(target, triangle.v0(), triangle.v1(), colour);
+    drawLine(target, triangle.v1(), triangle.v2(), colour);
+    drawLine(target, triangle.v2(), triangle.v0(), colour);
+}
+
+
+// returns the 2D CanvasPoint postion at which the model vertex should be projected onto the image plane
+// the one-vertex reference for viewProjectionMatrix and projectVertices
+CanvasPoint projectVertexOntoCanvasPoint(glm::vec3 cameraPostion, float focalLength, glm::vec3 vertexPosition, const RenderTarget &target){
+
+    CanvasPoint pointOnImage;
+    glm::vec3 relativePosition = cameraPostion - vertexPosition;
+    float scale = IMAGE_SCALE;
+
+    // u = - f * (x/z) + W/2
+    // v =   f * (y/z) + H/2
+    pointOnImage.x = scale * (focalLength * (-relativePosition.x / relativePosition.z))  + target.width() / 2;
+    pointOnImage.y = scale * (focalLength * (relativePosition.y / relativePosition.z)) + target.height() / 2;
+    pointOnImage.depth = 1/(relativePosition.z);
+
+    return pointOnImage;
+}
+
+// the culling stage: the mesh triangles that face the camera and are at least partly in view
+// shared by every render mode, so only these get projected
+//triangles crossing the near plane or the guard band are replaced by their clipped pieces, so nothing
+//gets divided by a z at or behind the camera and projected coordinates stay within a few screens of the window
+void cullMesh(const RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength,
+              std::vector<uint32_t> &visibleIndices, std::vector<ModelTriangle> &clipped){
+    ScopedStageTimer timer(profiler, FrameProfiler::CULL);
+    ViewFrustum frustum(cameraPos, focalLength, IMAGE_SCALE, target.width(), target.height(), NEAR_PLANE);
+    cullStats.reset();
+    cullTriangles(mesh, frustum, visibleIndices, clipped, cullStats);
+    profiler.count(FrameProfiler::TRIANGLES_IN, cullStats.submitted);
+    profiler.count(FrameProfiler::TRIANGLES_CULLED, cullStats.culled());
+}
+
+// the visible triangles and clipped pieces as standalone triangles, for the render modes that draw vertices and edges
+const std::vector<ModelTriangle> &visibleTriangles(const RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength){
+    static std::vector<uint32_t> visibleIndices;
+    static std::vector<ModelTriangle> visible;
+    cullMesh(target, mesh, cameraPos, focalLength, visibleIndices, visible);
+    //the clipped pieces are already in visible, put the whole triangles in front of them
+    visible.insert(visible.begin(), visibleIndices.size(), ModelTriangle());
+    for (size_t i = 0; i < visibleIndices.size(); i++) visible[i] = mesh.triangle(visibleIndices[i]);
+    return visible;
+}
+
+void renderPointCloud(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength)
+{
+    for (const ModelTriangle &triangle : visibleTriangles(target, mesh, cameraPos, focalLength))
+    {
+        // Project the 3D vertices onto the 2D canvas
+        for (int j = 0; j < 3; j++)
+        {
+            CanvasPoint point = projectVertexOntoCanvasPoint(
+                cameraPos,                // Camera position
+                focalLength,              // Focal length
+                triangle.vertices[j],    // Vertex position
+                target                    // Render target
+            );
+            // Draw the triangle on the canvas
+            uint32_t colour = (255 << 24) + (255 << 16) + (255 << 8) + int(255);
+            if (point.x >= 0 && point.y >= 0 && target.contains(point.x, point.y)) target.colourAt(point.x, point.y) = colour;
+        }
+    }
+}
+
+void renderWireframe(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength){
+    std::vector<CanvasTriangle> projectedTriangles;
+    for (const ModelTriangle &triangle : visibleTriangles(target, mesh, cameraPos, focalLength))
+    {
+        // Project the 3D vertices onto the 2D canvas
+        CanvasPoint projectedVertices[3];
+        for (int j = 0; j < 3; j++)
+        {
+            projectedVertices[j] = projectVertexOntoCanvasPoint(
+                cameraPos,                // Camera position
+                focalLength,              // Focal length
+                triangle.vertices[j],    // Vertex position
+                target                    // Render target
+            );
+        }
+
+        // Draw the triangle on the canvas
+        CanvasTriangle canvasTriangle(projectedVertices[0], projectedVertices[1], projectedVertices[2]);
+        //need to see which triangles have the greater depth to draw first
+
+
+        strokedTriangle(target, canvasTriangle, (*mesh.materialTable)[triangle.material]);
+    }
+}
+
+//stats, if given, counts the pixels the fill tests and writes
+void barycentricFillTriangle(RenderTarget &target, const CanvasTriangle &triangle, uint32_t colour, RasterStats *stats){
+    //only visit pixels that are within the window bounds
+    PixelRect screen = target.bounds();
+    PixelRect area = triangleBounds(triangle).intersect(screen);
+    //skip the whole triangle if it is behind everything already drawn there
+    if (target.depthPyramid().isOccluded(area, nearestDepth(triangle))) return;
+    RasterBuffer buffer = target.buffer();
+    buffer.stats = stats;
+    fillTriangle(triangle, screen, colour, buffer);
+    target.depthPyramid().propagate(area);
+}
+
+// project every triangle that survives culling onto the canvas, keeping the colours alongside
+//all the mesh vertices are projected in one batch, clipped pieces have vertices of their own and are projected one at a time
+void projectTriangles(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength,
+                      std::vector<CanvasTriangle> &projected, std::vector<uint32_t> &colours){
+    static std::vector<uint32_t> visibleIndices;
+    static std::vector<ModelTriangle> clipped;
+    cullMesh(target, mesh, cameraPos, focalLength, visibleIndices, clipped);
+    ScopedStageTimer timer(profiler, FrameProfiler::PROJECT);
+    //the camera isn't rotated, it looks down -z
+    glm::mat4 viewProjection = viewProjectionMatrix(cameraPos, glm::mat3(1.0f), focalLength, IMAGE_SCALE, target.width(), target.height());
+    projectVertices(viewProjection, mesh.vertices, projectedVertices);
+    projected.clear();
+    colours.clear();
+    for (uint32_t i : visibleIndices)
+    {
+        CanvasPoint corners[3];
+        for (int j = 0; j < 3; j++) corners[j] = projectedVertices.point(mesh.indices[3 * i + j]);
+        projected.push_back(CanvasTriangle(corners[0], corners[1], corners[2]));
+        colours.push_back(mesh.argb(i));
+    }
+    for (const ModelTriangle &piece : clipped)
+    {
+        CanvasPoint corners[3];
+        for (int j = 0; j < 3; j++) corners[j] = projectVertex(viewProjection, piece.vertices[j]);
+        projected.push_back(CanvasTriangle(corners[0], corners[1], corners[2]));
+        colours.push_back(mesh.materialTable->argb(piece.material));
+    }
+    profiler.count(FrameProfiler::TRIANGLES_DRAWN, projected.size());
+}
+
+// where this frame's fills should count, nothing unless the profiler or a heat map wants the counts
+RasterStats *rasterStatsFor(const RenderTarget &target, RasterStats &stats){
+    bool heatMap = renderMode != SHADED && overdrawMap.width() == target.width() && overdrawMap.height() == target.height();
+    if (heatMap) overdrawMap.attach(stats);
+    return (profiler.isEnabled() || heatMap) ? &stats : nullptr;
+}
+
+// hands the fill counts to the profiler, the fills only count when given somewhere to put them
+void countRasterStats(const RasterStats &stats){
+    profiler.count(FrameProfiler::PIXELS_TESTED, stats.pixelsTested);
+    profiler.count(FrameProfiler::PIXELS_WRITTEN, stats.pixelsWritten);
+}
+
+// reference path: fill the triangles one at a time on this thread
+void serialRasterisedRender(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength){
+    static std::vector<CanvasTriangle> projected;
+    static std::vector<uint32_t> colours;
+
+    projectTriangles(target, mesh, cameraPos, focalLength, projected, colours);
+    ScopedStageTimer timer(profiler, FrameProfiler::RASTERISE);
+    RasterStats stats;
+    RasterStats *counting = rasterStatsFor(target, stats);
+    for (size_t i = 0; i < projected.size(); i++) barycentricFillTriangle(target, projected[i], colours[i], counting);
+    countRasterStats(stats);
+}
+
+// bins the projected triangles into screen tiles and fills the tiles in parallel
+// gives exactly the same pixels as serialRasterisedRender
+void rasterisedRender(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength){
+    static TileRenderer tileRenderer(target.width(), target.height(), workerPool());
+    static std::vector<CanvasTriangle> projected;
+    static std::vector<uint32_t> colours;
+
+    tileRenderer.resize(target.width(), target.height());
+    projectTriangles(target, mesh, cameraPos, focalLength, projected, colours);
+    ScopedStageTimer timer(profiler, FrameProfiler::RASTERISE);
+    RasterStats stats;
+    RasterBuffer buffer = target.buffer();
+    buffer.stats = rasterStatsFor(target, stats);
+    tileRenderer.render(buffer, projected, colours);
+    countRasterStats(stats);
+}
+
+// renders the scene, or one of its heat maps, into the window with the profiler's HUD on top while it is on
+void drawFrame(DrawingWindow &window, RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength){
+    target.clear();
+    if (renderMode != SHADED)
+    {
+        if (overdrawMap.width() != target.width() || overdrawMap.height() != target.height()) overdrawMap.resize(target.width(), target.height());
+        else overdrawMap.clear();
+    }
+    //renderPointCloud(target, mesh, cameraPos, focalLength);
+    //renderWireframe(target, mesh, cameraPos, focalLength);
+    rasterisedRender(target, mesh, cameraPos, focalLength);
+    if (profiler.isEnabled())
+    {
+        //every pixel with a depth has been drawn at least once, which is what overdraw is measured against
+        const float *depth = target.depthData();
+        size_t covered = std::count_if(depth, depth + target.width() * target.height(), [](float d) { return d != 0.0f; });
+        profiler.count(FrameProfiler::PIXELS_COVERED, covered);
+    }
+    OverdrawMap::Kind kind = (renderMode == TEST_HEAT_MAP) ? OverdrawMap::DEPTH_TESTS : OverdrawMap::COLOUR_WRITES;
+    //the heat map replaces the colours, the depth buffer is left as it was rendered
+    if (renderMode != SHADED) overdrawMap.drawHeatMap(kind, target.colourData(), target.width());
+    window.blit(0, 0, target.colourData(), target.width(), target.height(), target.width());
+    if (renderMode != SHADED) overdrawMap.drawLegend(kind, window);
+    if (profiler.isEnabled()) profiler.drawHUD(window);
+}
+
+}
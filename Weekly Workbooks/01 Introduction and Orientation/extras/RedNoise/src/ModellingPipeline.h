@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <CanvasPoint.h>
+#include <CanvasTriangle.h>
+#include <Colour.h>
+#include <Culling.h>
+#include <DrawingWindow.h>
+#include <FrameProfiler.h>
+#include <IndexedMesh.h>
+#include <MaterialTable.h>
+#include <ModelTriangle.h>
+#include <OverdrawMap.h>
+#include <Rasteriser.h>
+#include <RenderTarget.h>
+#include <ThreadPool.h>
+#include <VertexProjection.h>
+
+// Loading, culling, projecting and rasterising the scene for 3DModelling, kept apart from its main so the benchmarks can call it too
+namespace modelling {
+
+//what the culling stage threw away in the last render
+extern CullStats cullStats;
+//screen positions of every mesh vertex for the current frame, so a vertex shared by several triangles is only projected once
+extern ProjectedVertices projectedVertices;
+//per-stage times and counts, 'p' turns it on with a HUD over the image and writes profile.json and profile.csv when turned off
+extern FrameProfiler profiler;
+//what the rasterised view shows, 'o' cycles from the shaded scene to heat maps of depth tests and colour writes per pixel
+enum RenderMode { SHADED, TEST_HEAT_MAP, WRITE_HEAT_MAP, RENDER_MODE_COUNT };
+extern RenderMode renderMode;
+//per-pixel counts behind the heat maps, only filled in while one is showing
+extern OverdrawMap overdrawMap;
+
+// one set of worker threads for loading and rendering
+ThreadPool &workerPool();
+
+// fill mesh from an .obj file, returns false, leaving mesh empty, if the file can't be opened or parsed
+bool processOBJFile(const std::string &filename, const MaterialTable &palette, IndexedMesh &mesh);
+// fill colours with a table of the colours in a .mtl file, returns false if the file can't be opened
+bool loadPalette(const std::string &filename, MaterialTable &colours);
+// the palette and then the mesh that uses it, false if either couldn't be loaded
+bool loadScene(const std::string &objPath, const std::string &mtlPath, IndexedMesh &mesh);
+
+void drawLine(RenderTarget &target, CanvasPoint from, CanvasPoint to, Colour colour_param);
+void strokedTriangle(RenderTarget &target, CanvasTriangle triangle, Colour colour);
+// returns the 2D CanvasPoint postion at which the model vertex should be projected onto the image plane
+CanvasPoint projectVertexOntoCanvasPoint(glm::vec3 cameraPostion, float focalLength, glm::vec3 vertexPosition, const RenderTarget &target);
+
+// the culling stage: the mesh triangles that face the camera and are at least partly in view, and the clipped pieces of the rest
+void cullMesh(const RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength,
+              std::vector<uint32_t> &visibleIndices, std::vector<ModelTriangle> &clipped);
+// the visible triangles and clipped pieces as standalone triangles, for the render modes that draw vertices and edges
+const std::vector<ModelTriangle> &visibleTriangles(const RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength);
+// project every triangle that survives culling onto the canvas, keeping the colours alongside
+void projectTriangles(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength,
+                      std::vector<CanvasTriangle> &projected, std::vector<uint32_t> &colours);
+
+void renderPointCloud(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength);
+void renderWireframe(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength);
+//stats, if given, counts the pixels the fill tests and writes
+void barycentricFillTriangle(RenderTarget &target, const CanvasTriangle &triangle, uint32_t colour, RasterStats *stats = nullptr);
+// where this frame's fills should count, nothing unless the profiler or a heat map wants the counts
+RasterStats *rasterStatsFor(const RenderTarget &target, RasterStats &stats);
+// hands the fill counts to the profiler
+void countRasterStats(const RasterStats &stats);
+// reference path: fill the triangles one at a time on this thread
+void serialRasterisedRender(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength);
+// bins the projected triangles into screen tiles and fills the tiles in parallel, same pixels as serialRasterisedRender
+void rasterisedRender(RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength);
+// renders the scene, or one of its heat maps, into the window with the profiler's HUD on top while it is on
+void drawFrame(DrawingWindow &window, RenderTarget &target, const MeshView &mesh, glm::vec3 cameraPos, float focalLength);
+
+}
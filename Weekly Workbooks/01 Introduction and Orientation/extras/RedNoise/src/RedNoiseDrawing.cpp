@@ -0,0 +1,219 @@
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <TextureCache.h>
+#include <TextureMap.h>
+#include <Rasteriser.h>
+#include <Utils.h>
+#include "RedNoiseDrawing.h"
+
+//where texture.ppm lives, the build points this at src
+#ifndef SCENE_DIR
+#define SCENE_DIR "src"
+#endif
+
+namespace rednoise {
+
+FrameProfiler profiler;
+
+// similar to interpolateSingleFloats but this time with 3-element values
+std::vector<float> interpolateSingleFloats(float from, float to, int numberOfValues){
+
+	// create an evenly spaced list of floats between from and to, size numberOfValues
+	std::vector<float> values;
+	float spacing = (to - from) / (numberOfValues - 1);
+	for (int i = 0; i < numberOfValues; i++)
+	{
+		values.push_back(from + i * spacing);
+	}
+	return values;
+}
+
+std::vector<glm::vec3> interpolateThreeElementValues(glm::vec3 from, glm::vec3 to, int numberOfValues){
+
+	std::vector<glm::vec3> values;
+	std::vector<float> spacing;
+	for (int i = 0; i < 3; i++)
+	{
+		spacing.push_back((to[i] - from[i]) / (numberOfValues - 1));
+	}
+	for (int i = 0; i < numberOfValues; i++)
+	{
+		values.push_back({(from.x + i * spacing[0]), (from.y + i * spacing[1]), (from.z + i * spacing[2])});
+	}
+	return values;
+}
+
+void draw(DrawingWindow &window){
+	window.clearPixels();
+	for (size_t y = 0; y < window.height; y++)
+	{
+		for (size_t x = 0; x < window.width; x++)
+		{
+			float red = rand() % 256;
+			float green = 0;
+			float blue = 0;
+			uint32_t colour = (255 << 24) + (int(red) << 16) + (int(green) << 8) + int(blue);
+			window.setPixelColour(x, y, colour);
+		}
+	}
+}
+
+void drawGrey(DrawingWindow &window){
+
+	window.clearPixels();
+	std::vector<float> values = interpolateSingleFloats(255, 0, window.width);
+	// every row is the same, so work it out once and copy it down the window
+	std::vector<uint32_t> row(window.width);
+	for (size_t x = 0; x < window.width; x++)
+	{
+		float red = values[x];
+		float green = values[x];
+		float blue = values[x];
+		row[x] = (255 << 24) + (int(red) << 16) + (int(green) << 8) + int(blue);
+	}
+	for (size_t y = 0; y < window.height; y++) window.writeRow(0, y, row.data(), window.width);
+}
+
+void twoDimensionInterpolation(DrawingWindow &window){
+
+	glm::vec3 topLeft(255, 0, 0);	   // red
+	glm::vec3 topRight(0, 0, 255);	   // blue
+	glm::vec3 bottomRight(0, 255, 0);  // green
+	glm::vec3 bottomLeft(255, 255, 0); // yellow
+	window.clearPixels();
+
+	std::vector<glm::vec3> leftColumn = interpolateThreeElementValues(topLeft, bottomLeft, window.height);
+	std::vector<glm::vec3> rightColumn = interpolateThreeElementValues(topRight, bottomRight, window.height);
+
+	for (size_t y = 0; y < window.height; y++)
+	{
+		std::vector<glm::vec3> values = interpolateThreeElementValues(leftColumn[y], rightColumn[y], window.width);
+		uint32_t *row = window.getRow(y);
+		for (size_t x = 0; x < window.width; x++)
+		{
+			float red = values[x].x;
+			float green = values[x].y;
+			float blue = values[x].z;
+			row[x] = (255 << 24) + (int(red) << 16) + (int(green) << 8) + int(blue);
+		}
+	}
+}
+
+void barycentricTriangularInterpolation(DrawingWindow &window){
+
+	glm::vec2 v0(0, window.height - 1);					   // bottom left
+	glm::vec2 v1((window.width - 1) / 2, 0);			   // top
+	glm::vec2 v2((window.width - 1), (window.height - 1)); // bottom right
+
+	for (size_t y = 0; y < window.height; y++)
+	{
+		for (size_t x = 0; x < window.width; x++)
+		{
+			glm::vec3 coords = convertToBarycentricCoordinates(v0, v1, v2, glm::vec2(x, y));
+
+			if (coords.x >= 0 && coords.y >= 0 && coords.z >= 0)
+			{
+				float red = coords.z * 255;
+				float green = coords.x * 255;
+				float blue = coords.y * 255;
+				uint32_t colour = (255 << 24) + (int(red) << 16) + (int(green) << 8) + int(blue);
+				window.setPixelColour(x, y, colour);
+			}
+		}
+	}
+}
+
+
+void drawLine(DrawingWindow &window, CanvasPoint from, CanvasPoint to, Colour colour_param){
+
+	uint32_t colour = (255 << 24) + (int(colour_param.red) << 16) + (int(colour_param.green) << 8) + int(colour_param.blue);
+	if (from.x == to.x && from.y == to.y)
+	{
+		window.setPixelColour(from.x, from.y, colour);
+		return;
+	}
+	float x_dist = to.x - from.x;
+	float y_dist = to.y - from.y;
+
+	float numberOfSteps = fmax(abs(x_dist), abs(y_dist));
+	float x_spacing = x_dist / numberOfSteps;
+	float y_spacing = y_dist / numberOfSteps;
+
+	for (int i = 0; i <= numberOfSteps; i++)
+	{
+		float x = from.x + (x_spacing * i);
+		float y = from.y + (y_spacing * i);
+
+		window.setPixelColour(round(x), round(y), colour);
+	}
+}
+
+void strokedTriangle(DrawingWindow &window, CanvasTriangle triangle, Colour colour){
+
+	drawLine(window, triangle.v0(), triangle.v1(), colour);
+	drawLine(window, triangle.v1(), triangle.v2(), colour);
+	drawLine(window, triangle.v2(), triangle.v0(), colour);
+}
+
+// returns a vector of all the points between p1 and p2
+std::vector<CanvasPoint> interpolate2Coords(CanvasPoint p1, CanvasPoint p2){
+
+	std::vector<CanvasPoint> pointsBetween;
+	float x_dist = p2.x - p1.x;
+	float y_dist = p2.y - p1.y;
+
+	float numberOfSteps = fmax(abs(x_dist), abs(y_dist));
+	float x_spacing = x_dist / numberOfSteps;
+	float y_spacing = y_dist / numberOfSteps;
+
+	for (int i = 0; i <= numberOfSteps; i++)
+	{
+		float x = p1.x + (x_spacing * i);
+		float y = p1.y + (y_spacing * i);
+
+		pointsBetween.push_back(CanvasPoint(x, y));
+	}
+	return pointsBetween;
+}
+
+// calculate proportional distance of point along line from "from" to "to"
+float proportion(CanvasPoint from, CanvasPoint to, CanvasPoint point){
+
+	float lineLength = sqrt(pow((to.x - from.x), 2) + pow((to.y - from.y), 2));
+	float pointLength = sqrt(pow((point.x - from.x), 2) + pow((point.y - from.y), 2));
+
+	return pointLength / lineLength;
+}
+
+// given a start and end coord, return pos of a single pixel on that line with a given proportion
+TexturePoint texturePointOnLine(TexturePoint from, TexturePoint to, float proportion){
+	float x_dist = to.x - from.x;
+	float y_dist = to.y - from.y;
+
+	float x = from.x + (x_dist * proportion);
+	float y = from.y + (y_dist * proportion);
+	// print original and new points
+	return TexturePoint(round(x), round(y));
+}
+
+// fill the triangle with the shared fixed point rasteriser, so triangles sharing an edge don't overlap or leave gaps
+void drawFilledTriangle(DrawingWindow &window, CanvasTriangle triangle, Colour colour_param){
+
+	uint32_t colour = (255 << 24) + (int(colour_param.red) << 16) + (int(colour_param.green) << 8) + int(colour_param.blue);
+	PixelRect screen(0, 0, window.width - 1, window.height - 1);
+	fillTriangleColour(triangle, screen, colour, window.getPixelBuffer(), window.width);
+}
+
+void textureMapping(DrawingWindow &window, CanvasTriangle target){
+
+	// only the first call reads and decodes the file, after that it comes from the shared cache
+	std::shared_ptr<const TextureMap> texture = textureCache().get(SCENE_DIR "/texture.ppm");
+	// sample the texture where it is, clamping any texture point that falls off its edge
+	PixelRect screen(0, 0, window.width - 1, window.height - 1);
+	ScopedStageTimer timer(profiler, FrameProfiler::TEXTURE);
+	fillTriangleTextured(target, screen, *texture, TEXTURE_CLAMP, window.getPixelBuffer(), window.width);
+}
+
+}
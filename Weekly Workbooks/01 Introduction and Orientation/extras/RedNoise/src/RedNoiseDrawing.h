@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include <CanvasPoint.h>
+#include <CanvasTriangle.h>
+#include <Colour.h>
+#include <DrawingWindow.h>
+#include <FrameProfiler.h>
+#include <TexturePoint.h>
+
+// The 2D drawing that RedNoise does, kept apart from its main so the benchmarks can call it too
+namespace rednoise {
+
+// times texture sampling and presenting, 'p' turns it on and writes profile.json and profile.csv when turned off
+extern FrameProfiler profiler;
+
+// create an evenly spaced list of floats between from and to, size numberOfValues
+std::vector<float> interpolateSingleFloats(float from, float to, int numberOfValues);
+// similar to interpolateSingleFloats but this time with 3-element values
+std::vector<glm::vec3> interpolateThreeElementValues(glm::vec3 from, glm::vec3 to, int numberOfValues);
+
+void draw(DrawingWindow &window);
+void drawGrey(DrawingWindow &window);
+void twoDimensionInterpolation(DrawingWindow &window);
+void barycentricTriangularInterpolation(DrawingWindow &window);
+
+void drawLine(DrawingWindow &window, CanvasPoint from, CanvasPoint to, Colour colour_param);
+void strokedTriangle(DrawingWindow &window, CanvasTriangle triangle, Colour colour);
+// returns a vector of all the points between p1 and p2
+std::vector<CanvasPoint> interpolate2Coords(CanvasPoint p1, CanvasPoint p2);
+// calculate proportional distance of point along line from "from" to "to"
+float proportion(CanvasPoint from, CanvasPoint to, CanvasPoint point);
+// given a start and end coord, return pos of a single pixel on that line with a given proportion
+TexturePoint texturePointOnLine(TexturePoint from, TexturePoint to, float proportion);
+// fill the triangle with the shared fixed point rasteriser, so triangles sharing an edge don't overlap or leave gaps
+void drawFilledTriangle(DrawingWindow &window, CanvasTriangle triangle, Colour colour_param);
+// fill the triangle from SCENE_DIR/texture.ppm, throws std::invalid_argument if it can't be loaded
+void textureMapping(DrawingWindow &window, CanvasTriangle target);
+
+}